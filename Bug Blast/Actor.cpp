@@ -1,10 +1,10 @@
 #include "Actor.h"
-#include <queue>
 #include <cstdlib>
+#include <climits>
 #include "Level.h"
 #include <list>
+#include <vector>
 #include "StudentWorld.h"
-#include <time.h>
 
 using namespace std;
 
@@ -12,10 +12,14 @@ using namespace std;
 //Implementation for Actor
 
 //Public
-Actor::Actor(int graphID, int x, int y, StudentWorld* world) : GraphObject(graphID, x, y){
+Actor::Actor(int graphID, int x, int y, StudentWorld* world) : GraphObject(graphID, x, y, world->getGraphObjects()){
 	setVisible(true);
 	m_alive = true;
 	m_world = world;
+	m_kind = 1u << graphID;
+}
+
+Actor::~Actor(){
 }
 
 void Actor::setDead(){
@@ -26,6 +30,14 @@ bool Actor::isAlive() const{
 	return m_alive;
 }
 
+unsigned int Actor::getKind() const{
+	return m_kind;
+}
+
+bool Actor::isKind(unsigned int mask) const{
+	return (m_kind & mask) != 0;
+}
+
 //Protected
 bool Actor::tryMoveIn(int dir){
 	switch (dir){
@@ -58,7 +70,13 @@ bool Actor::tryMoveIn(int dir){
 }
 
 bool Actor::canMove(int x, int y) const{
-	return x >= 0 && x < VIEW_WIDTH && y >= 0 && y < VIEW_HEIGHT;
+	return x >= 0 && x < m_world->getBoardWidth() && y >= 0 && y < m_world->getBoardHeight();
+}
+
+//Hides GraphObject::moveTo so the world's occupancy grid follows every move
+void Actor::moveTo(int x, int y){
+	m_world->moveActor(this, x, y);
+	GraphObject::moveTo(x, y);
 }
 
 bool Actor::samePos(const Actor* other) const{
@@ -69,6 +87,11 @@ StudentWorld* Actor::getWorld() const{
 	return m_world;
 }
 
+void Actor::setWorld(StudentWorld* world){
+	m_world = world;
+	setRegistry(world->getGraphObjects());
+}
+
 Level* Actor::getLevel() const{
 	return m_world->getCurrentLevel();
 }
@@ -77,6 +100,10 @@ Player* Actor::getPlayer() const{
 	return m_world->getPlayer();
 }
 
+int Actor::getRand(int n) const{
+	return m_world->getRand(n);
+}
+
 //=================================
 //Implementation for Bricks
 
@@ -84,6 +111,9 @@ Player* Actor::getPlayer() const{
 Brick::Brick(int graphID, int x, int y, StudentWorld* world) : Actor(graphID, x, y, world){
 }
 
+Brick::~Brick(){
+}
+
 void Brick::doSomething(){
 }
 
@@ -106,19 +136,28 @@ DestroyableBrick::DestroyableBrick(int x, int y, StudentWorld* world) : Brick(II
 
 //Public
 Player::Player(int x, int y, StudentWorld* world) : Actor(IID_PLAYER, x, y, world){
-	m_maxNumSprayers = getLevel()->getOptionValue(optionMaxBoostedSprayers);
+	m_maxNumSprayers = getLevel()->getOption(OPTION_MAX_BOOSTED_SPRAYERS);
+	m_sprayRadius = getLevel()->getOption(OPTION_SPRAY_RADIUS, BUGSPRAY_REACH);
 	m_walkThruTick = 0;
 	m_extraSprayerTick = 0;
+	m_causeOfDeath = CAUSE_NONE;
 };
 
 void Player::doSomething(){
 	if (!isAlive())
 		return;
 
-	if (getWorld()->contains<Zumi>(getX(), getY()) || getWorld()->contains<BugSpray>(getX(), getY()) || 
-		getWorld()->contains<PermaBrick>(getX(), getY()) || getWorld()->contains<DestroyableBrick>(getX(), getY()) && m_walkThruTick <= 0){
-			setDead();
-			return;
+	int cause = CAUSE_NONE;
+	StudentWorld* world = getWorld();
+	if (world->getLayer(LAYER_ZUMIS).test(getX(), getY()))
+		cause = CAUSE_ZUMI;
+	else if (world->getLayer(LAYER_SPRAY).test(getX(), getY()))
+		cause = CAUSE_BUG_SPRAY;
+	else if (world->getLayer(LAYER_WALLS).test(getX(), getY()) || world->getLayer(LAYER_BRICKS).test(getX(), getY()) && m_walkThruTick <= 0)
+		cause = CAUSE_BRICK;
+	if (cause != CAUSE_NONE){
+		setDeadBy(cause);
+		return;
 	}
 
 	if (m_walkThruTick > 0)
@@ -135,7 +174,7 @@ void Player::doSomething(){
 			if (numSprayers < NUM_MAX_SPRAYERS_ALLOWED || m_extraSprayerTick>0 && numSprayers<m_maxNumSprayers)
 				//Check the location is not occupied by an invalid object
 				if (!getWorld()->contains<Brick>(getX(), getY()) && !getWorld()->contains<BugSprayer>(getX(), getY()))
-					getWorld()->addActor(new BugSprayer(getX(), getY(), getWorld()));
+					getWorld()->addPooled<BugSprayer>(getX(), getY(), getWorld(), m_sprayRadius);
 		}
 		else
 			tryMoveIn(dir);
@@ -148,10 +187,27 @@ void Player::setDead(){
 	getWorld()->playSound(SOUND_PLAYER_DIE);
 }
 
+void Player::setDeadBy(int cause){
+	m_causeOfDeath = cause;
+	setDead();
+}
+
+int Player::getCauseOfDeath() const{
+	return m_causeOfDeath;
+}
+
 void Player::setWalkThruTick(int tick){
 	m_walkThruTick = tick;
 }
 
+int Player::getSprayRadius() const{
+	return m_sprayRadius;
+}
+
+void Player::incSprayRadius(){
+	m_sprayRadius++;
+}
+
 void Player::setExtraSprayerTick(int tick){
 	m_extraSprayerTick = tick;
 }
@@ -161,9 +217,9 @@ bool Player::canMove(int x, int y) const{
 	if (!Actor::canMove(x, y))
 		return false;
 
-	list<Actor*> actors = getWorld()->getActors();
-	for (list<Actor*>::iterator it = actors.begin(); it != actors.end(); it++){
-		if (((*it)->getX() == x && (*it)->getY() == y) && (dynamic_cast<PermaBrick*>(*it) || dynamic_cast<DestroyableBrick*>(*it) && m_walkThruTick <= 0))
+	const vector<Actor*>& actors = getWorld()->getActorsAt(x, y);
+	for (size_t i = 0; i < actors.size(); i++){
+		if (actors[i]->isKind(KIND_PERMA_BRICK) || actors[i]->isKind(KIND_DESTROYABLE_BRICK) && m_walkThruTick <= 0)
 			return false;
 	}
 
@@ -199,6 +255,9 @@ void Exit::activate(){
 Item::Item(int graphID, int x, int y, StudentWorld* world) : Actor(graphID, x, y, world){
 }
 
+Item::~Item(){
+}
+
 void Item::doSomething(){
 	if (!isAlive())
 		return;
@@ -236,7 +295,8 @@ bool Item::decLifeTime(){
 //Implementation for BugSprayer
 
 //Public
-BugSprayer::BugSprayer(int x, int y, StudentWorld* world) : Item(IID_BUGSPRAYER, x, y, world){
+BugSprayer::BugSprayer(int x, int y, StudentWorld* world, int radius) : Item(IID_BUGSPRAYER, x, y, world){
+	m_radius = radius;
 	world->incNumSprayers();
 	setLifeTime(BUGSPRAYER_TICK);
 }
@@ -246,41 +306,21 @@ BugSprayer::~BugSprayer(){
 }
 
 void BugSprayer::setDead(){
-	Actor::setDead();
-
-	getWorld()->playSound(SOUND_SPRAY);
-
-	//Add the sprays
-	//current location
-	getWorld()->addActor(new BugSpray(getX(), getY(), getWorld()));
+	if (!isAlive())
+		return;
 
-	bool goNegDir = true, goPosDir = true;
-	//Horizaontal
-	for (int i = 1; i <= 2; i++){
-		if (goPosDir && !getWorld()->contains<PermaBrick>(getX() + i, getY()))
-			getWorld()->addActor(new BugSpray(getX() + i, getY(), getWorld()));
-		if (getWorld()->contains<Brick>(getX() + i, getY()))
-			goPosDir = false;
+	//The world sets this sprayer off together with every sprayer its spray reaches
+	getWorld()->detonate(this);
+}
 
-		if (goNegDir && !getWorld()->contains<PermaBrick>(getX() - i, getY()))
-			getWorld()->addActor(new BugSpray(getX() - i, getY(), getWorld()));
-		if (getWorld()->contains<Brick>(getX() - i, getY()))
-			goNegDir = false;
-	}
+int BugSprayer::getRadius() const{
+	return m_radius;
+}
 
-	//Vertical
-	goNegDir = true, goPosDir = true;
-	for (int i = 1; i <= 2; i++){
-		if (goPosDir && !getWorld()->contains<PermaBrick>(getX(), getY() + i))
-			getWorld()->addActor(new BugSpray(getX(), getY() + i, getWorld()));
-		if (getWorld()->contains<Brick>(getX(), getY() + i))
-			goPosDir = false;
-
-		if (goNegDir && !getWorld()->contains<PermaBrick>(getX(), getY() - i))
-			getWorld()->addActor(new BugSpray(getX(), getY() - i, getWorld()));
-		if (getWorld()->contains<Brick>(getX(), getY() - i))
-			goNegDir = false;
-	}
+//Called by StudentWorld::detonate for each sprayer in the chain
+void BugSprayer::explode(){
+	Actor::setDead();
+	setLifeTime(0);
 }
 
 //Protected
@@ -297,20 +337,9 @@ BugSpray::BugSpray(int x, int y, StudentWorld* world) : Item(IID_BUGSPRAY, x, y,
 
 //Protected
 void BugSpray::useItemEffect(){
-	//Check if NPCs should be killed
-	list<Actor*>* actors = &(getWorld()->getActors());
-	for (list<Actor*>::iterator it = actors->begin(); it != actors->end(); it++){
-		if (samePos(*it)){
-			if (dynamic_cast<DestroyableBrick*>(*it) || dynamic_cast<Zumi*>(*it))
-				(*it)->setDead();
-			else if (dynamic_cast<BugSprayer*>(*it))
-				dynamic_cast<BugSprayer*>(*it)->setLifeTime(0);
-		}
-	}
-	//Check if the PC should be killed
-	Player* player = getWorld()->getPlayer();
-	if (samePos(player))
-		player->setDead();
+	//StudentWorld::applySprayDamage hurts whatever is here, along with the
+	//cells of the rest of this spray's run
+	getWorld()->addSprayDamage(getX(), getY());
 }
 
 //=================================
@@ -318,7 +347,7 @@ void BugSpray::useItemEffect(){
 
 //Public
 ExtraLifeGoodie::ExtraLifeGoodie(int x, int y, StudentWorld* world) : Item(IID_EXTRA_LIFE_GOODIE, x, y, world){
-	setLifeTime(getLevel()->getOptionValue(optionGoodieLifetimeInTicks));
+	setLifeTime(getLevel()->getOption(OPTION_GOODIE_LIFETIME_IN_TICKS));
 }
 
 //Protected
@@ -332,12 +361,12 @@ void ExtraLifeGoodie::useItemEffect(){
 //=================================
 //Implementation for WalkThruGoodie
 WalkThruGoodie::WalkThruGoodie(int x, int y, StudentWorld* world) : Item(IID_WALK_THRU_GOODIE, x, y, world){
-	setLifeTime(getLevel()->getOptionValue(optionGoodieLifetimeInTicks));
+	setLifeTime(getLevel()->getOption(OPTION_GOODIE_LIFETIME_IN_TICKS));
 }
 
 void WalkThruGoodie::useItemEffect(){
 	if (playerGotItem()){
-		getWorld()->getPlayer()->setWalkThruTick(getLevel()->getOptionValue(optionWalkThruLifetimeTicks));
+		getWorld()->getPlayer()->setWalkThruTick(getLevel()->getOption(OPTION_WALK_THRU_LIFETIME_TICKS));
 		setDead();
 	}
 }
@@ -345,12 +374,27 @@ void WalkThruGoodie::useItemEffect(){
 //=================================
 //Implementation for ExtraSprayerGoodie
 ExtraSprayerGoodie::ExtraSprayerGoodie(int x, int y, StudentWorld* world) : Item(IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE, x, y, world){
-	setLifeTime(getLevel()->getOptionValue(optionGoodieLifetimeInTicks));
+	setLifeTime(getLevel()->getOption(OPTION_GOODIE_LIFETIME_IN_TICKS));
 }
 
 void ExtraSprayerGoodie::useItemEffect(){
 	if (playerGotItem()){
-		getWorld()->getPlayer()->setExtraSprayerTick(getLevel()->getOptionValue(optionBoostedSprayerLifetimeTicks));
+		getWorld()->getPlayer()->setExtraSprayerTick(getLevel()->getOption(OPTION_BOOSTED_SPRAYER_LIFETIME_TICKS));
+		setDead();
+	}
+}
+
+//=================================
+//Implementation for SprayRadiusGoodie
+SprayRadiusGoodie::SprayRadiusGoodie(int x, int y, StudentWorld* world) : Item(IID_INCREASE_SPRAY_RADIUS_GOODIE, x, y, world){
+	setLifeTime(getLevel()->getOption(OPTION_GOODIE_LIFETIME_IN_TICKS));
+}
+
+//Every one collected makes the player's sprayers reach a cell further,
+//until the player dies
+void SprayRadiusGoodie::useItemEffect(){
+	if (playerGotItem()){
+		getWorld()->getPlayer()->incSprayRadius();
 		setDead();
 	}
 }
@@ -361,10 +405,13 @@ void ExtraSprayerGoodie::useItemEffect(){
 //Public
 Zumi::Zumi(int graphID, int x, int y, StudentWorld* world) : Actor(graphID, x, y, world){
 	m_tickCount = 0;
-	setTickPerMove(getLevel()->getOptionValue(optionTicksPerSimpleZumiMove));
+	setTickPerMove(getLevel()->getOption(OPTION_TICKS_PER_SIMPLE_ZUMI_MOVE));
 	setDir();
 }
 
+Zumi::~Zumi(){
+}
+
 void Zumi::doSomething(){
 	if (!isAlive())
 		return;
@@ -372,7 +419,7 @@ void Zumi::doSomething(){
 	Player* player = getWorld()->getPlayer();
 	if (samePos(player)){
 		getWorld()->playSound(SOUND_PLAYER_DIE);
-		player->setDead();
+		player->setDeadBy(CAUSE_ZUMI);
 	}
 
 	if (shouldAct()){
@@ -387,24 +434,22 @@ void Zumi::setDead(){
 	//Play the sound
 	getWorld()->playSound(SOUND_ENEMY_DIE);
 
-	//Decide whether we should drop a goodie
-	if (getRand(100) < (int)(getLevel()->getOptionValue(optionProbOfGoodieOverall))){
-		//Decide which type to drop
-		int probExtraLife = getLevel()->getOptionValue(optionProbOfExtraLifeGoodie);
-		int probExtraSprayer = getLevel()->getOptionValue(optionProbOfMoreSprayersGoodie);
-		int probWalkthru = getLevel()->getOptionValue(optionProbOfWalkThruGoodie);
-		int rand = getRand(probExtraLife + probExtraSprayer + probWalkthru);
-
-		//Life Goodie
-		if (rand < probExtraLife)
-			getWorld()->addActor(new ExtraLifeGoodie(getX(), getY(), getWorld()));
-		//Extra Sprayer Goodie
-		else if (probExtraLife <= rand && rand < probExtraLife + probExtraSprayer)
-			getWorld()->addActor(new ExtraSprayerGoodie(getX(), getY(), getWorld()));
-		//Walk Thru Goodie
-		else if (probExtraLife + probExtraSprayer <= rand && rand < probExtraLife + probExtraSprayer + probWalkthru)
-			getWorld()->addActor(new WalkThruGoodie(getX(), getY(), getWorld()));
-
+	//Decide whether we should drop a goodie, and which
+	switch (getWorld()->rollGoodieDrop()){
+	case DROP_EXTRA_LIFE:
+		getWorld()->addPooled<ExtraLifeGoodie>(getX(), getY(), getWorld());
+		break;
+	case DROP_MORE_SPRAYERS:
+		getWorld()->addPooled<ExtraSprayerGoodie>(getX(), getY(), getWorld());
+		break;
+	case DROP_WALK_THRU:
+		getWorld()->addPooled<WalkThruGoodie>(getX(), getY(), getWorld());
+		break;
+	case DROP_SPRAY_RADIUS:
+		getWorld()->addPooled<SprayRadiusGoodie>(getX(), getY(), getWorld());
+		break;
+	case DROP_NONE:
+		break;
 	}
 }
 
@@ -456,8 +501,8 @@ void SimpleZumi::setDead(){
 
 //Public
 ComplexZumi::ComplexZumi(int x, int y, StudentWorld* world) : Zumi(IID_COMPLEX_ZUMI, x, y, world){
-	setTickPerMove(getLevel()->getOptionValue(optionTicksPerComplexZumiMove));
-	m_smellDistance = getLevel()->getOptionValue(optionComplexZumiSearchDistance);
+	setTickPerMove(getLevel()->getOption(OPTION_TICKS_PER_COMPLEX_ZUMI_MOVE));
+	m_smellDistance = getLevel()->getOption(OPTION_COMPLEX_ZUMI_SEARCH_DISTANCE);
 }
 
 //Protected
@@ -510,103 +555,7 @@ void ComplexZumi::act(){
 
 //Private
 int ComplexZumi::getDistToPlayer(int sx, int sy){
-	//We use a Coord class to simplify our calculation
-	class Coord
-	{
-	public:
-		Coord(int x, int y) : m_x(x), m_y(y) {}
-		bool operator==(const Coord& other){
-			return other.m_x == m_x && other.m_y == m_y;
-		}
-		int getX() { return m_x; }
-		int getY() { return m_y; }
-	private:
-		int m_x;
-		int m_y;
-	};
-
-	//We also need a variable to keep track of these distance
-	int dist = 1;
-	//This keep track of the coords
-	queue<Coord> coords;
-	//This will help us avoid over counting
-	queue<int> branchCounts;
-
-	//Get the maze
-	string maze[VIEW_WIDTH], temp;
-	for (int j = 0; j < VIEW_HEIGHT; j++)
-		temp += ".";
-	for (int i = 0; i < VIEW_WIDTH; i++)	
-		maze[i] = temp;
-	
-	list<Actor*> * actors = &(getWorld()->getActors());
-	for (list<Actor*>::iterator it = actors->begin(); it != actors->end(); it++){
-		if (dynamic_cast<Brick*>(*it) || dynamic_cast<BugSprayer*>(*it))
-			maze[(*it)->getX()][(*it)->getY()] = '#';
-	}
-
-	//Get where the player is
-	Coord playerLoc = Coord(getWorld()->getPlayer()->getX(), getWorld()->getPlayer()->getY());
-
-	//Get the initial coord in and check the initial coordinate is valid
-	if (maze[sx][sy] != '.')
-		return INT_MAX;
-	coords.push(Coord(sx, sy));
-	branchCounts.push(1);
-	maze[sx][sy] = '#';
-
-	while (!coords.empty()){
-		//Get the number of branches
-		int numBranch = branchCounts.front();
-		branchCounts.pop();
-
-		int branchCount = 0;
-
-		//We need to traverse through all the branches 
-		for (int i = 0; i < numBranch; i++){
-			//Get the stuff out of the queue
-			Coord currCoord = coords.front();
-			coords.pop();
-
-			//If we have reached the player, return the distance
-			if (currCoord == playerLoc)
-				return dist;
-
-			//Add more coords into the queue
-			//North
-			if (currCoord.getY() + 1 < VIEW_HEIGHT && maze[currCoord.getX()][currCoord.getY() + 1] == '.'){
-				coords.push(Coord(currCoord.getX(), currCoord.getY() + 1));
-				maze[currCoord.getX()][currCoord.getY() + 1] = '&';
-				branchCount++;
-			}
-			//South
-			if (currCoord.getY() - 1 >= 0 && maze[currCoord.getX()][currCoord.getY() - 1] == '.'){
-				coords.push(Coord(currCoord.getX(), currCoord.getY() - 1));
-				maze[currCoord.getX()][currCoord.getY() - 1] = '&';
-				branchCount++;
-			}
-			//West
-			if (currCoord.getX() - 1 >= 0 && maze[currCoord.getX()-1][currCoord.getY()] == '.'){
-				coords.push(Coord(currCoord.getX() - 1, currCoord.getY()));
-				maze[currCoord.getX() - 1][currCoord.getY()] = '&';
-				branchCount++;
-			}
-			//East
-			if (currCoord.getX() + 1 < VIEW_WIDTH && maze[currCoord.getX() + 1][currCoord.getY()] == '.'){
-				coords.push(Coord(currCoord.getX() + 1, currCoord.getY()));
-				maze[currCoord.getX() + 1][currCoord.getY()] = '&';
-				branchCount++;
-			}
-		}
-		//Incrase the depth by 1
-		dist++;
-		branchCounts.push(branchCount);
-	}
-	return INT_MAX;
+	//All complex zumis share one distance field per tick, kept by the world
+	return getWorld()->getDistToPlayer(sx, sy);
 }
 
-//=================================
-//Implementation for Auxillary functions
-int getRand(int n){
-	return rand() % n;
-}
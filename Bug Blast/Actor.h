@@ -3,6 +3,7 @@
 
 #include "GraphObject.h"
 #include "GameConstants.h"
+#include "ActorKind.h"
 
 class Level;
 class Player;
@@ -16,28 +17,44 @@ const int SIMPLE_ZUMI_SCORE = 100;
 const int COMPLEX_ZUMI_SCORE = 500;
 const int BUGSPRAYER_TICK = 40;
 const int BUGSPRAY_TICK = 3;
+const int BUGSPRAY_REACH = 2;		//unless the level sets sprayRadius
+
+//What killed the player
+const int CAUSE_NONE = 0;
+const int CAUSE_ZUMI = 1;
+const int CAUSE_BUG_SPRAY = 2;
+const int CAUSE_BRICK = 3;
 
 //=================================================
-//Basic Actor class
+//Basic Actor class. Actors live in StudentWorld's level arena, which drops
+//them at the end of a level without running their destructors, so an actor
+//must not own memory or anything else that needs cleaning up.
 class Actor : public GraphObject{
 public:
 	Actor(int graphID, int x, int y, StudentWorld* world);
-	virtual ~Actor() = 0{ };
+	virtual ~Actor() = 0;
 	virtual void doSomething() = 0;
 	virtual void setDead();
 	bool isAlive() const;
+	unsigned int getKind() const;
+	bool isKind(unsigned int mask) const;
+	//For a level built by one world and taken over by another
+	void setWorld(StudentWorld* world);
 
 protected:
 	bool tryMoveIn(int dir);
+	void moveTo(int x, int y);
 	virtual bool canMove(int x, int y) const;
 	bool samePos(const Actor* other) const;
 	StudentWorld* getWorld() const;
 	Level* getLevel() const;
 	Player* getPlayer() const;
+	int getRand(int n) const;
 
 private:
 	StudentWorld* m_world;
 	bool m_alive;
+	unsigned int m_kind;
 };
 
 //=================================================
@@ -45,7 +62,7 @@ private:
 class Brick : public Actor{
 public:
 	Brick(int graphID, int x, int y, StudentWorld* world);
-	virtual ~Brick() = 0 {};
+	virtual ~Brick() = 0;
 	void doSomething();
 };
 
@@ -66,8 +83,12 @@ public:
 	Player(int x, int y, StudentWorld* world);
 	virtual void doSomething();
 	virtual void setDead();
+	void setDeadBy(int cause);
+	int getCauseOfDeath() const;
 	void setWalkThruTick(int tick);
 	void setExtraSprayerTick(int tick);
+	int getSprayRadius() const;
+	void incSprayRadius();
 
 protected:
 	virtual bool canMove(int x, int y) const;
@@ -76,6 +97,8 @@ private:
 	int m_walkThruTick;
 	int m_extraSprayerTick;
 	int m_maxNumSprayers;
+	int m_sprayRadius;
+	int m_causeOfDeath;
 };
 
 //==================================================
@@ -95,7 +118,7 @@ private:
 class Item : public Actor{
 public:
 	Item(int graphID, int x, int y, StudentWorld* world);
-	virtual ~Item() = 0 {};
+	virtual ~Item() = 0;
 	virtual void doSomething();
 	void setLifeTime(int lifeTime);
 
@@ -113,12 +136,17 @@ private:
 //Bug Sprayer Class
 class BugSprayer : public Item{
 public:
-	BugSprayer(int x, int y, StudentWorld* world);
+	BugSprayer(int x, int y, StudentWorld* world, int radius = BUGSPRAY_REACH);
 	virtual ~BugSprayer();
 	virtual void setDead();
+	void explode();
+	int getRadius() const;
 
 protected:
 	virtual void useItemEffect();
+
+private:
+	int m_radius;
 };
 
 //==================================================
@@ -161,12 +189,22 @@ protected:
 	virtual void useItemEffect();
 };
 
+//==================================================
+//SprayRadiusGoodie Class
+class SprayRadiusGoodie : public Item{
+public:
+	SprayRadiusGoodie(int x, int y, StudentWorld* world);
+
+protected:
+	virtual void useItemEffect();
+};
+
 //==================================================
 //Zumi Class
 class Zumi : public Actor{
 public:
 	Zumi(int graphID, int x, int y, StudentWorld* world);
-	virtual ~Zumi() = 0 {};
+	virtual ~Zumi() = 0;
 	virtual void doSomething();
 	virtual void setDead();
 
@@ -208,8 +246,4 @@ private:
 	int m_smellDistance;
 };
 
-//==================================================
-//Auxillary Function Declarations
-int getRand(int n);
-
 #endif // ACTOR_H_
@@ -0,0 +1,68 @@
+#ifndef ACTORKIND_H_
+#define ACTORKIND_H_
+
+#include "GameConstants.h"
+
+//=================================================
+//Every concrete actor has its own image ID, so one bit per image ID tells
+//them apart. A family of actors (all bricks, all zumis...) is the OR of its
+//members' bits, and "is this a Zumi?" becomes a mask test instead of a
+//dynamic_cast.
+const unsigned int KIND_PLAYER = 1u << IID_PLAYER;
+const unsigned int KIND_SIMPLE_ZUMI = 1u << IID_SIMPLE_ZUMI;
+const unsigned int KIND_COMPLEX_ZUMI = 1u << IID_COMPLEX_ZUMI;
+const unsigned int KIND_EXIT = 1u << IID_EXIT;
+const unsigned int KIND_BUGSPRAYER = 1u << IID_BUGSPRAYER;
+const unsigned int KIND_BUGSPRAY = 1u << IID_BUGSPRAY;
+const unsigned int KIND_EXTRA_LIFE_GOODIE = 1u << IID_EXTRA_LIFE_GOODIE;
+const unsigned int KIND_WALK_THRU_GOODIE = 1u << IID_WALK_THRU_GOODIE;
+const unsigned int KIND_EXTRA_SPRAYER_GOODIE = 1u << IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE;
+const unsigned int KIND_PERMA_BRICK = 1u << IID_PERMA_BRICK;
+const unsigned int KIND_DESTROYABLE_BRICK = 1u << IID_DESTROYABLE_BRICK;
+const unsigned int KIND_SPRAY_RADIUS_GOODIE = 1u << IID_INCREASE_SPRAY_RADIUS_GOODIE;
+
+const unsigned int KIND_BRICK = KIND_PERMA_BRICK | KIND_DESTROYABLE_BRICK;
+const unsigned int KIND_ZUMI = KIND_SIMPLE_ZUMI | KIND_COMPLEX_ZUMI;
+const unsigned int KIND_GOODIE = KIND_EXTRA_LIFE_GOODIE | KIND_WALK_THRU_GOODIE | KIND_EXTRA_SPRAYER_GOODIE | KIND_SPRAY_RADIUS_GOODIE;
+const unsigned int KIND_ITEM = KIND_BUGSPRAYER | KIND_BUGSPRAY | KIND_GOODIE;
+const unsigned int KIND_ANY = ~0u;
+
+//=================================================
+//The mask for each class in the Actor hierarchy, so that templates such as
+//StudentWorld::contains<Type> turn into a constant mask at compile time
+class Actor;
+class Brick;
+class PermaBrick;
+class DestroyableBrick;
+class Player;
+class Exit;
+class Item;
+class BugSprayer;
+class BugSpray;
+class ExtraLifeGoodie;
+class WalkThruGoodie;
+class ExtraSprayerGoodie;
+class SprayRadiusGoodie;
+class Zumi;
+class SimpleZumi;
+class ComplexZumi;
+
+template<typename Type> struct KindOf;
+template<> struct KindOf<Actor> { static const unsigned int mask = KIND_ANY; };
+template<> struct KindOf<Brick> { static const unsigned int mask = KIND_BRICK; };
+template<> struct KindOf<PermaBrick> { static const unsigned int mask = KIND_PERMA_BRICK; };
+template<> struct KindOf<DestroyableBrick> { static const unsigned int mask = KIND_DESTROYABLE_BRICK; };
+template<> struct KindOf<Player> { static const unsigned int mask = KIND_PLAYER; };
+template<> struct KindOf<Exit> { static const unsigned int mask = KIND_EXIT; };
+template<> struct KindOf<Item> { static const unsigned int mask = KIND_ITEM; };
+template<> struct KindOf<BugSprayer> { static const unsigned int mask = KIND_BUGSPRAYER; };
+template<> struct KindOf<BugSpray> { static const unsigned int mask = KIND_BUGSPRAY; };
+template<> struct KindOf<ExtraLifeGoodie> { static const unsigned int mask = KIND_EXTRA_LIFE_GOODIE; };
+template<> struct KindOf<WalkThruGoodie> { static const unsigned int mask = KIND_WALK_THRU_GOODIE; };
+template<> struct KindOf<ExtraSprayerGoodie> { static const unsigned int mask = KIND_EXTRA_SPRAYER_GOODIE; };
+template<> struct KindOf<SprayRadiusGoodie> { static const unsigned int mask = KIND_SPRAY_RADIUS_GOODIE; };
+template<> struct KindOf<Zumi> { static const unsigned int mask = KIND_ZUMI; };
+template<> struct KindOf<SimpleZumi> { static const unsigned int mask = KIND_SIMPLE_ZUMI; };
+template<> struct KindOf<ComplexZumi> { static const unsigned int mask = KIND_COMPLEX_ZUMI; };
+
+#endif // ACTORKIND_H_
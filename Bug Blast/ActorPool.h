@@ -0,0 +1,94 @@
+#ifndef ACTORPOOL_H_
+#define ACTORPOOL_H_
+
+#include "LevelArena.h"
+#include <new>
+#include <cstddef>
+
+//=================================================
+//A free list of Type-sized slots carved out of blocks of SLOTS_PER_BLOCK,
+//for the actors that come and go all game (sprays, sprayers, goodies).
+//create/destroy reuse slots instead of going to the heap. The blocks come
+//from the level's arena, so they go when the level does: reset() the pool
+//whenever its arena is released.
+//Only the member functions need Type to be complete, so a pool can be a
+//member of a class that just forward declares Type.
+template<typename Type>
+class ActorPool{
+public:
+	ActorPool(LevelArena& arena) : m_arena(arena), m_free(nullptr), m_numUsed(0), m_capacity(0){
+	}
+
+	template<typename... Args>
+	Type* create(Args... args){
+		return new (allocate()) Type(args...);
+	}
+
+	void destroy(Type* actor){
+		actor->~Type();
+		pushFree(reinterpret_cast<Slot*>(actor));
+		m_numUsed--;
+	}
+
+	//Forgets every slot, destroyed or not, along with the blocks they were in
+	void reset(){
+		m_free = nullptr;
+		m_numUsed = 0;
+		m_capacity = 0;
+	}
+
+	size_t getNumUsed() const{
+		return m_numUsed;
+	}
+
+	size_t getCapacity() const{
+		return m_capacity;
+	}
+
+private:
+	static const size_t SLOTS_PER_BLOCK = 64;
+
+	struct Slot{
+		Slot* next;
+	};
+
+	//A slot big enough for either a Type or a free list link, rounded up so
+	//that every slot in a block stays aligned for Type
+	static size_t slotSize(){
+		size_t size = sizeof(Type) > sizeof(Slot) ? sizeof(Type) : sizeof(Slot);
+		return (size + alignof(Type) - 1) / alignof(Type) * alignof(Type);
+	}
+
+	static Slot* slotAt(void* block, size_t i){
+		return reinterpret_cast<Slot*>(static_cast<char*>(block) + i * slotSize());
+	}
+
+	void pushFree(Slot* slot){
+		slot->next = m_free;
+		m_free = slot;
+	}
+
+	void* allocate(){
+		if (m_free == nullptr){
+			void* block = m_arena.allocate(SLOTS_PER_BLOCK * slotSize(), alignof(Type));
+			m_capacity += SLOTS_PER_BLOCK;
+			for (size_t j = SLOTS_PER_BLOCK; j-- > 0; )
+				pushFree(slotAt(block, j));
+		}
+		Slot* slot = m_free;
+		m_free = slot->next;
+		m_numUsed++;
+		return slot;
+	}
+
+	//Prevent copying: the slots belong to exactly one pool
+	ActorPool(const ActorPool&);
+	ActorPool& operator=(const ActorPool&);
+
+	LevelArena& m_arena;
+	Slot* m_free;
+	size_t m_numUsed;
+	size_t m_capacity;
+};
+
+#endif // ACTORPOOL_H_
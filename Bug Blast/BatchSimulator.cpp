@@ -0,0 +1,120 @@
+#include "BatchSimulator.h"
+#include "HeadlessDriver.h"
+#include "StudentWorld.h"
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <chrono>
+using namespace std;
+
+namespace
+{
+	struct WorkQueue
+	{
+		mutex		   lock;
+		deque<size_t> jobs;
+	};
+
+	bool popOwnJob(WorkQueue& q, size_t& job)
+	{
+		lock_guard<mutex> guard(q.lock);
+		if (q.jobs.empty())
+			return false;
+		job = q.jobs.back();
+		q.jobs.pop_back();
+		return true;
+	}
+
+	bool stealJob(WorkQueue& q, size_t& job)
+	{
+		lock_guard<mutex> guard(q.lock);
+		if (q.jobs.empty())
+			return false;
+		job = q.jobs.front();
+		q.jobs.pop_front();
+		return true;
+	}
+
+	BatchResult playJob(const BatchJob& job)
+	{
+		  // One seed drives both the world and the bot, on separate streams.
+		RandomGenerator streams(job.seed);
+		StudentWorld world;
+		world.setRandomGenerator(streams.split());
+		world.startAtLevel(job.startLevel);
+		world.setLevelPack(job.levelPack);
+
+		KeySource* keys;
+		if (job.script.empty())
+			keys = new RandomKeySource(streams.split());
+		else
+			keys = new ScriptedKeySource(job.script);
+
+		HeadlessDriver driver(&world, keys);
+		HeadlessStats stats = driver.run(job.maxTicks);
+		delete keys;
+
+		BatchResult result;
+		result.status = stats.lastStatus;
+		result.causeOfDeath = world.getLastCauseOfDeath();
+		result.ticks = stats.ticks;
+		result.levelsCompleted = stats.levelsCompleted;
+		result.finalLevel = stats.finalLevel;
+		result.score = stats.finalScore;
+		return result;
+	}
+
+	void worker(size_t self, vector<WorkQueue>& queues, const vector<BatchJob>& jobs, vector<BatchResult>& results)
+	{
+		size_t job;
+		for (;;)
+		{
+			bool found = popOwnJob(queues[self], job);
+
+			  // Jobs never spawn jobs, so once every queue is empty we're done.
+			for (size_t k = 1; !found  &&  k < queues.size(); k++)
+				found = stealJob(queues[(self + k) % queues.size()], job);
+			if (!found)
+				return;
+
+			results[job] = playJob(jobs[job]);  // each job writes only its own slot
+		}
+	}
+}
+
+BatchSimulator::BatchSimulator(unsigned int threads)
+ : m_threads(threads)
+{
+	if (m_threads == 0)
+		m_threads = thread::hardware_concurrency();
+	if (m_threads == 0)
+		m_threads = 1;
+}
+
+BatchSummary BatchSimulator::run(const vector<BatchJob>& jobs)
+{
+	BatchSummary summary;
+	summary.results.resize(jobs.size());
+	summary.threads = m_threads;
+
+	vector<WorkQueue> queues(m_threads);
+	for (size_t k = 0; k < jobs.size(); k++)
+		queues[k % m_threads].jobs.push_back(k);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	vector<thread> workers;
+	for (size_t t = 1; t < m_threads; t++)
+		workers.push_back(thread(worker, t, ref(queues), cref(jobs), ref(summary.results)));
+	worker(0, queues, jobs, summary.results);
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+
+	chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+	summary.seconds = chrono::duration<double>(stop - start).count();
+	summary.totalTicks = 0;
+	for (size_t k = 0; k < summary.results.size(); k++)
+		summary.totalTicks += summary.results[k].ticks;
+	return summary;
+}
@@ -0,0 +1,60 @@
+#ifndef BATCHSIMULATOR_H_
+#define BATCHSIMULATOR_H_
+
+#include <vector>
+#include <cstdint>
+
+class LevelPack;
+
+  // One independent game for the batch simulator to play headlessly.
+
+struct BatchJob
+{
+	unsigned int	 startLevel;
+	uint64_t		 seed;		// seeds the world's RandomGenerator (and the bot's, if there's no script)
+	std::vector<int> script;	// one key per tick (INVALID_KEY for none); empty means a RandomKeySource
+	unsigned long	 maxTicks;	// 0 means play until the game ends
+	const LevelPack* levelPack;	// shared by every job that uses it; NULL means levelNN files
+};
+
+struct BatchResult
+{
+	int				status;		// as in HeadlessStats::lastStatus
+	int				causeOfDeath;
+	unsigned long	ticks;
+	unsigned int	levelsCompleted;
+	unsigned int	finalLevel;
+	unsigned int	score;
+};
+
+struct BatchSummary
+{
+	std::vector<BatchResult> results;	// in the same order as the jobs
+	unsigned int	threads;
+	unsigned long	totalTicks;
+	double			seconds;
+
+	double worldTicksPerSecond() const
+	{
+		return seconds > 0 ? totalTicks / seconds : 0;
+	}
+};
+
+  // Plays many StudentWorlds at once, one per worker thread at a time.
+  // Each worker starts with its share of the jobs and, once it runs dry,
+  // steals from the other end of a busier worker's queue, so a few long
+  // games don't leave the other cores idle.
+
+class BatchSimulator
+{
+  public:
+	  // 0 threads means one per hardware thread.
+	BatchSimulator(unsigned int threads = 0);
+
+	BatchSummary run(const std::vector<BatchJob>& jobs);
+
+  private:
+	unsigned int m_threads;
+};
+
+#endif // BATCHSIMULATOR_H_
@@ -0,0 +1,203 @@
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+#include "GameConstants.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+//=================================================
+//One bit per board cell, cell (x, y) being bit y * width + x, packed into
+//64-bit words (four of them for a 15x15 board). Whole-board questions such
+//as "which cells border the frontier?" or "where does the spray land?"
+//become a few shifts and masks per word instead of a loop over cells.
+class Bitboard{
+public:
+	Bitboard(int width = VIEW_WIDTH, int height = VIEW_HEIGHT) : m_width(width), m_height(height){
+		//Zero words either side of the board let a shift by up to a whole
+		//row read past the ends without any bounds checks
+		m_numWords = (width * height + 63) / 64;
+		m_pad = (width + 63) / 64 + 1;
+		m_data.assign(m_pad + m_numWords + m_pad + 3 * m_numWords, 0);
+		uint64_t* onBoard = mask(MASK_ON_BOARD);
+		uint64_t* notFirstColumn = mask(MASK_NOT_FIRST_COLUMN);
+		uint64_t* notLastColumn = mask(MASK_NOT_LAST_COLUMN);
+		for (int cell = 0; cell < width * height; cell++){
+			uint64_t bit = uint64_t(1) << (cell % 64);
+			onBoard[cell / 64] |= bit;
+			if (cell % width != 0)
+				notFirstColumn[cell / 64] |= bit;
+			if (cell % width != width - 1)
+				notLastColumn[cell / 64] |= bit;
+		}
+	}
+
+	int getWidth() const{
+		return m_width;
+	}
+	int getHeight() const{
+		return m_height;
+	}
+
+	//Off the board is always clear
+	bool test(int x, int y) const{
+		return inBounds(x, y) && test(y * m_width + x);
+	}
+	bool test(int cell) const{
+		return (words()[cell / 64] >> (cell % 64)) & 1;
+	}
+
+	void set(int x, int y, bool value = true){
+		if (!inBounds(x, y))
+			return;
+		int cell = y * m_width + x;
+		uint64_t bit = uint64_t(1) << (cell % 64);
+		if (value)
+			words()[cell / 64] |= bit;
+		else
+			words()[cell / 64] &= ~bit;
+	}
+
+	void clear(){
+		std::fill(words(), words() + m_numWords, 0);
+	}
+
+	//Every cell on the board
+	void setAll(){
+		std::copy(mask(MASK_ON_BOARD), mask(MASK_ON_BOARD) + m_numWords, words());
+	}
+
+	bool any() const{
+		const uint64_t* w = words();
+		for (int i = 0; i < m_numWords; i++)
+			if (w[i] != 0)
+				return true;
+		return false;
+	}
+
+	//All of these expect boards of the same size
+	Bitboard& operator|=(const Bitboard& other){
+		uint64_t* w = words();
+		const uint64_t* o = other.words();
+		for (int i = 0; i < m_numWords; i++)
+			w[i] |= o[i];
+		return *this;
+	}
+	Bitboard& operator&=(const Bitboard& other){
+		uint64_t* w = words();
+		const uint64_t* o = other.words();
+		for (int i = 0; i < m_numWords; i++)
+			w[i] &= o[i];
+		return *this;
+	}
+	Bitboard& andNot(const Bitboard& other){
+		uint64_t* w = words();
+		const uint64_t* o = other.words();
+		for (int i = 0; i < m_numWords; i++)
+			w[i] &= ~o[i];
+		return *this;
+	}
+
+	void swap(Bitboard& other){
+		std::swap(m_width, other.m_width);
+		std::swap(m_height, other.m_height);
+		std::swap(m_numWords, other.m_numWords);
+		std::swap(m_pad, other.m_pad);
+		m_data.swap(other.m_data);
+	}
+
+	//Move every set cell one step by (dx, dy), each -1, 0 or 1; cells that
+	//would leave the board are dropped rather than wrapping onto the next row
+	void shift(int dx, int dy){
+		int offset = dy * m_width + dx;
+		uint64_t* w = words();
+		const uint64_t* keep = mask(dx > 0 ? MASK_NOT_FIRST_COLUMN : dx < 0 ? MASK_NOT_LAST_COLUMN : MASK_ON_BOARD);
+		//Work away from the words still to be read
+		if (offset > 0)
+			for (int i = m_numWords - 1; i >= 0; i--)
+				w[i] = shiftedUp(w, i, offset) & keep[i];
+		else
+			for (int i = 0; i < m_numWords; i++)
+				w[i] = shiftedDown(w, i, -offset) & keep[i];
+	}
+
+	//Become source plus every cell next to one of its cells
+	void spreadFrom(const Bitboard& source){
+		uint64_t* w = words();
+		const uint64_t* s = source.words();
+		const uint64_t* onBoard = mask(MASK_ON_BOARD);
+		const uint64_t* notFirstColumn = mask(MASK_NOT_FIRST_COLUMN);
+		const uint64_t* notLastColumn = mask(MASK_NOT_LAST_COLUMN);
+		for (int i = 0; i < m_numWords; i++)
+			w[i] = (s[i]
+				| (shiftedUp(s, i, 1) & notFirstColumn[i])
+				| (shiftedDown(s, i, 1) & notLastColumn[i])
+				| shiftedUp(s, i, m_width)
+				| shiftedDown(s, i, m_width)) & onBoard[i];
+	}
+
+	//For walking the set cells a word at a time:
+	//	for each word i:
+	//		while (word != 0) { cell = i * 64 + lowestBit(word); word &= word - 1; }
+	int getNumWords() const{
+		return m_numWords;
+	}
+	uint64_t getWord(int i) const{
+		return words()[i];
+	}
+	static int lowestBit(uint64_t word){
+#if defined(__GNUC__)
+		return __builtin_ctzll(word);
+#else
+		//De Bruijn multiplication, for compilers without the builtin
+		static const int index[64] = {
+			0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+			62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+			63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+			46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+		};
+		return index[((word & (0 - word)) * 0x03f79d71b4cb0a89ULL) >> 58];
+#endif
+	}
+
+private:
+	enum Mask{ MASK_ON_BOARD, MASK_NOT_FIRST_COLUMN, MASK_NOT_LAST_COLUMN };
+
+	bool inBounds(int x, int y) const{
+		return x >= 0 && x < m_width && y >= 0 && y < m_height;
+	}
+
+	uint64_t* words(){
+		return &m_data[m_pad];
+	}
+	const uint64_t* words() const{
+		return &m_data[m_pad];
+	}
+	uint64_t* mask(Mask which){
+		return &m_data[m_pad + m_numWords + m_pad + which * m_numWords];
+	}
+	const uint64_t* mask(Mask which) const{
+		return &m_data[m_pad + m_numWords + m_pad + which * m_numWords];
+	}
+
+	//Word i of the board moved bits places towards the high end or the low
+	//end; bits is at most a row, so the padding covers any word read.
+	//(x >> (63 - r)) >> 1 is x >> (64 - r), but still zero when r is 0.
+	static uint64_t shiftedUp(const uint64_t* w, int i, int bits){
+		int from = i - bits / 64, r = bits % 64;
+		return (w[from] << r) | ((w[from - 1] >> (63 - r)) >> 1);
+	}
+	static uint64_t shiftedDown(const uint64_t* w, int i, int bits){
+		int from = i + bits / 64, r = bits % 64;
+		return (w[from] >> r) | ((w[from + 1] << (63 - r)) << 1);
+	}
+
+	int m_width;
+	int m_height;
+	int m_numWords;
+	int m_pad;
+	//Padding, the board, padding, then the three masks
+	std::vector<uint64_t> m_data;
+};
+
+#endif // BITBOARD_H_
@@ -0,0 +1,102 @@
+#include "BlastEngine.h"
+
+using namespace std;
+
+BlastEngine::BlastEngine(int width, int height) : m_width(width), m_height(height){
+	reset();
+}
+
+void BlastEngine::reset(){
+	m_contents.assign(m_width * m_height, OPEN);
+	for (int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		m_reach[dir].assign(m_width * m_height, 0);
+	m_rowStale.assign(m_height, true);
+	m_columnStale.assign(m_width, true);
+}
+
+void BlastEngine::setWall(int x, int y){
+	setContents(x, y, WALL);
+}
+
+void BlastEngine::setBrick(int x, int y, bool present){
+	setContents(x, y, present ? BRICK : OPEN);
+}
+
+void BlastEngine::getBlastCells(int x, int y, int radius, vector<BlastCell>& cells){
+	cells.clear();
+	if (!inBounds(x, y))
+		return;
+	if (m_rowStale[y])
+		rebuildRow(y);
+	if (m_columnStale[x])
+		rebuildColumn(x);
+
+	BlastCell origin = { x, y };
+	cells.push_back(origin);
+
+	//Each pair of directions alternates outward, the order sprays always had
+	const int dx[NUM_DIRECTIONS] = { 1, -1, 0, 0 };
+	const int dy[NUM_DIRECTIONS] = { 0, 0, 1, -1 };
+	int cell = y * m_width + x;
+	for (int dir = 0; dir < NUM_DIRECTIONS; dir += 2){
+		int reachPos = m_reach[dir][cell] < radius ? m_reach[dir][cell] : radius;
+		int reachNeg = m_reach[dir + 1][cell] < radius ? m_reach[dir + 1][cell] : radius;
+		for (int i = 1; i <= reachPos || i <= reachNeg; i++){
+			if (i <= reachPos){
+				BlastCell hit = { x + dx[dir] * i, y + dy[dir] * i };
+				cells.push_back(hit);
+			}
+			if (i <= reachNeg){
+				BlastCell hit = { x + dx[dir + 1] * i, y + dy[dir + 1] * i };
+				cells.push_back(hit);
+			}
+		}
+	}
+}
+
+//Private
+void BlastEngine::setContents(int x, int y, Contents contents){
+	if (!inBounds(x, y) || m_contents[y * m_width + x] == contents)
+		return;
+	m_contents[y * m_width + x] = contents;
+	m_rowStale[y] = true;
+	m_columnStale[x] = true;
+}
+
+//How far a spray gets past a cell, given what is in the next cell along and
+//how far it gets past that one
+int BlastEngine::reachThrough(unsigned char next, int nextReach){
+	switch (next){
+	case WALL:
+		return 0;
+	case BRICK:
+		return 1;
+	default:
+		return 1 + nextReach;
+	}
+}
+
+void BlastEngine::rebuildRow(int y){
+	int* right = &m_reach[RIGHT][y * m_width];
+	int* left = &m_reach[LEFT][y * m_width];
+	const unsigned char* row = &m_contents[y * m_width];
+	right[m_width - 1] = 0;
+	for (int x = m_width - 2; x >= 0; x--)
+		right[x] = reachThrough(row[x + 1], right[x + 1]);
+	left[0] = 0;
+	for (int x = 1; x < m_width; x++)
+		left[x] = reachThrough(row[x - 1], left[x - 1]);
+	m_rowStale[y] = false;
+}
+
+void BlastEngine::rebuildColumn(int x){
+	vector<int>& up = m_reach[UP];
+	vector<int>& down = m_reach[DOWN];
+	up[(m_height - 1) * m_width + x] = 0;
+	for (int y = m_height - 2; y >= 0; y--)
+		up[y * m_width + x] = reachThrough(m_contents[(y + 1) * m_width + x], up[(y + 1) * m_width + x]);
+	down[x] = 0;
+	for (int y = 1; y < m_height; y++)
+		down[y * m_width + x] = reachThrough(m_contents[(y - 1) * m_width + x], down[(y - 1) * m_width + x]);
+	m_columnStale[x] = false;
+}
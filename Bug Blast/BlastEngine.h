@@ -0,0 +1,56 @@
+#ifndef BLASTENGINE_H_
+#define BLASTENGINE_H_
+
+#include "GameConstants.h"
+#include <vector>
+
+struct BlastCell{
+	int x;
+	int y;
+};
+
+//=================================================
+//Works out where a bug sprayer's spray lands. For every cell and each of the
+//four directions it keeps how far a spray starting there can travel: perma
+//bricks soak the spray up, destroyable bricks take it but stop it going any
+//further. A blast is then just a walk along four known lengths.
+//
+//The lengths only change when a brick disappears, and then only along that
+//brick's row and column, so those are marked stale and recomputed the next
+//time a blast starts in them.
+class BlastEngine{
+public:
+	BlastEngine(int width = VIEW_WIDTH, int height = VIEW_HEIGHT);
+
+	//Forget every brick
+	void reset();
+
+	void setWall(int x, int y);
+	void setBrick(int x, int y, bool present);
+
+	//Replace cells with the cells a blast at (x, y) reaching radius cells each
+	//way covers: (x, y) itself, then outward right, left, right, left... and
+	//then up, down, up, down...
+	void getBlastCells(int x, int y, int radius, std::vector<BlastCell>& cells);
+
+private:
+	enum Direction{ RIGHT, LEFT, UP, DOWN, NUM_DIRECTIONS };
+	enum Contents{ OPEN, WALL, BRICK };
+
+	bool inBounds(int x, int y) const{
+		return x >= 0 && x < m_width && y >= 0 && y < m_height;
+	}
+	void setContents(int x, int y, Contents contents);
+	static int reachThrough(unsigned char next, int nextReach);
+	void rebuildRow(int y);
+	void rebuildColumn(int x);
+
+	int m_width;
+	int m_height;
+	std::vector<unsigned char> m_contents;
+	std::vector<int> m_reach[NUM_DIRECTIONS];	//cells a spray from here covers going that way
+	std::vector<bool> m_rowStale;
+	std::vector<bool> m_columnStale;
+};
+
+#endif // BLASTENGINE_H_
@@ -0,0 +1,161 @@
+#include "CompiledLevel.h"
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+using namespace std;
+
+const char* const CompiledLevel::FILE_EXTENSION = ".bbl";
+
+static const char	  LEVEL_MAGIC[4] = { 'B', 'B', 'L', 'V' };
+static const uint32_t LEVEL_VERSION = 2;
+static const size_t	  HEADER_SIZE = 20;
+static const size_t	  VERSION_1_HEADER_SIZE = 16;  // no source checksum
+static const size_t	  CHECKSUM_SIZE = 4;
+
+static uint32_t fnv1a(const char* data, size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t k = 0; k < size; k++)
+	{
+		hash ^= static_cast<unsigned char>(data[k]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void putBytes(vector<char>& out, uint32_t value, int numBytes)
+{
+	for (int k = 0; k < numBytes; k++)
+		out.push_back(static_cast<char>((value >> (8*k)) & 0xff));
+}
+
+static uint32_t getBytes(const char* data, int numBytes)
+{
+	uint32_t value = 0;
+	for (int k = 0; k < numBytes; k++)
+		value |= uint32_t(static_cast<unsigned char>(data[k])) << (8*k);
+	return value;
+}
+
+static size_t mazeBytes(size_t width, size_t height)
+{
+	return (width * height + 1) / 2;
+}
+
+  // The header size for a file of this version, or 0 for one this cannot read
+static size_t headerSize(const char* data, size_t size)
+{
+	if (size < VERSION_1_HEADER_SIZE  ||
+		!equal(data, data + sizeof(LEVEL_MAGIC), LEVEL_MAGIC))
+		return 0;
+	uint32_t version = getBytes(data + 4, 4);
+	if (version == 1)
+		return VERSION_1_HEADER_SIZE;
+	if (version == LEVEL_VERSION  &&  size >= HEADER_SIZE)
+		return HEADER_SIZE;
+	return 0;
+}
+
+void CompiledLevel::compile(const Level& level, vector<char>& out, uint32_t source)
+{
+	size_t start = out.size();
+	out.insert(out.end(), LEVEL_MAGIC, LEVEL_MAGIC + sizeof(LEVEL_MAGIC));
+	putBytes(out, LEVEL_VERSION, 4);
+	putBytes(out, level.m_width, 2);
+	putBytes(out, level.m_height, 2);
+	putBytes(out, source, 4);
+	putBytes(out, NUM_LEVEL_OPTIONS, 4);
+	for (int k = 0; k < NUM_LEVEL_OPTIONS; k++)
+		putBytes(out, level.m_options[k], 4);
+
+	size_t maze = out.size();
+	size_t numCells = level.m_maze.size();
+	out.resize(maze + mazeBytes(level.m_width, level.m_height), 0);
+	for (size_t cell = 0; cell < numCells; cell++)
+		out[maze + cell/2] |= static_cast<char>(level.m_maze[cell] << (4 * (cell % 2)));
+
+	putBytes(out, fnv1a(&out[start], out.size() - start), 4);
+}
+
+Level::LoadResult CompiledLevel::load(Level& level, const char* data, size_t size)
+{
+	size_t header = headerSize(data, size);
+	if (header == 0)
+		return Level::load_fail_bad_format;
+
+	size_t width = getBytes(data + 8, 2);
+	size_t height = getBytes(data + 10, 2);
+	size_t numOptions = getBytes(data + header - 4, 4);
+	if (numOptions < NUM_REQUIRED_OPTIONS  ||  numOptions > NUM_LEVEL_OPTIONS)
+		return Level::load_fail_bad_format;
+
+	size_t maze = header + 4 * numOptions;
+	if (size != maze + mazeBytes(width, height) + CHECKSUM_SIZE  ||
+		fnv1a(data, size - CHECKSUM_SIZE) != getBytes(data + size - CHECKSUM_SIZE, 4))
+		return Level::load_fail_bad_format;
+
+	  // Options added to the game after the file was compiled are left out
+	for (size_t k = 0; k < NUM_LEVEL_OPTIONS; k++)
+		level.m_options[k] = k < numOptions ? getBytes(data + header + 4*k, 4) : INVALID_SETTING;
+	level.m_settingsMap.clear();
+
+	if (!level.setSize(width, height))
+		return Level::load_fail_bad_format;
+	size_t numCells = width * height;
+	for (size_t cell = 0; cell < numCells; cell++)
+	{
+		int entry = (static_cast<unsigned char>(data[maze + cell/2]) >> (4 * (cell % 2))) & 0xf;
+		if (entry > Level::destroyable_brick)
+			return Level::load_fail_bad_format;
+		level.m_maze[cell] = static_cast<unsigned char>(entry);
+	}
+
+	level.buildGoodieTable();
+	return Level::load_success;
+}
+
+Level::LoadResult CompiledLevel::load(Level& level, string filename, string textName)
+{
+	ifstream in(filename.c_str(), ios::binary);
+	if (!in)
+		return Level::load_fail_file_not_found;
+	vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	if (data.empty())
+		return Level::load_fail_bad_format;
+
+	  // Compiled from some other text, or (a version 1 file) from text it
+	  // cannot name: the text wins
+	uint32_t source = textName.empty() ? 0 : sourceChecksum(textName);
+	if (source != 0  &&
+		(headerSize(&data[0], data.size()) != HEADER_SIZE  ||  getBytes(&data[12], 4) != source))
+		return Level::load_fail_file_not_found;
+	return load(level, &data[0], data.size());
+}
+
+bool CompiledLevel::save(const Level& level, string filename, uint32_t source)
+{
+	vector<char> data;
+	compile(level, data, source);
+	ofstream out(filename.c_str(), ios::binary);
+	out.write(&data[0], data.size());
+	out.close();
+	return !out.fail();
+}
+
+uint32_t CompiledLevel::sourceChecksum(string textName)
+{
+	ifstream in(textName.c_str(), ios::binary);
+	if (!in)
+		return 0;
+	vector<char> text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	uint32_t hash = fnv1a(text.empty() ? NULL : &text[0], text.size());
+	return hash != 0 ? hash : 1;
+}
+
+string CompiledLevel::compiledName(string textName)
+{
+	string::size_type dot = textName.rfind('.');
+	if (dot != string::npos  &&  textName.find('/', dot) == string::npos)
+		textName.erase(dot);
+	return textName + FILE_EXTENSION;
+}
@@ -0,0 +1,56 @@
+#ifndef COMPILEDLEVEL_H_
+#define COMPILEDLEVEL_H_
+
+#include "Level.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+  // The binary form levelc writes for a level file that has passed
+  // Level::loadLevel's checks:
+  //
+  //   "BBLV", version        4 bytes each
+  //   width, height          2 bytes each
+  //   source checksum        4 bytes, sourceChecksum of the level file it
+  //                          was compiled from (0 if unknown)
+  //   option count           4 bytes
+  //   option values          4 bytes each, in LevelOption order
+  //                          (INVALID_SETTING for options left out)
+  //   maze                   one MazeEntry per half byte, low half first,
+  //                          rows from y = 0 up
+  //   checksum               4 bytes, FNV-1a over everything before it
+  //
+  // All numbers are little-endian.  Since the text was validated when it
+  // was compiled, loading only checks the header, the size and the
+  // checksum before copying the settings and maze straight in.  Options
+  // the game does not know about are not kept.  Version 1 files, which
+  // have no source checksum, still load.
+
+class CompiledLevel
+{
+  public:
+	static const char* const FILE_EXTENSION;  // ".bbl"
+
+	  // Appends level's compiled form to out; source is the sourceChecksum
+	  // of the file level was read from.
+	static void compile(const Level& level, std::vector<char>& out, uint32_t source = 0);
+
+	  // The compiled form of a level file must fill size bytes at data.
+	static Level::LoadResult load(Level& level, const char* data, size_t size);
+
+	  // Given the level file it was compiled from, a compiled file that is
+	  // out of date with it (the text was edited since) is treated as
+	  // missing: load_fail_file_not_found, so the caller reads the text.
+	static Level::LoadResult load(Level& level, std::string filename, std::string textName = "");
+
+	static bool save(const Level& level, std::string filename, uint32_t source = 0);
+
+	  // A hash of the level file's bytes, never 0; 0 if it cannot be read.
+	static uint32_t sourceChecksum(std::string textName);
+
+	  // levelNN.dat -> levelNN.bbl
+	static std::string compiledName(std::string textName);
+};
+
+#endif // COMPILEDLEVEL_H_
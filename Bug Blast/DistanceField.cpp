@@ -0,0 +1,228 @@
+#include "DistanceField.h"
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+const int DistanceField::UNREACHABLE;
+
+DistanceField::DistanceField(int width, int height) : m_width(width), m_height(height),
+	m_blocked(width, height), m_unreached(width, height), m_frontier(width, height), m_next(width, height){
+	m_queue.reserve(width * height);
+	m_depthLimit = UNREACHABLE;
+	m_fullSearches = 0;
+	m_repairs = 0;
+	m_cellsExpanded = 0;
+	reset();
+}
+
+void DistanceField::reset(){
+	m_target = -1;
+	m_valid = false;
+	m_dist.assign(m_width * m_height, UNREACHABLE);
+	m_blocked.clear();
+	m_mark.assign(m_width * m_height, 0);
+	m_generation = 0;
+}
+
+void DistanceField::setBlocked(int x, int y, bool blocked){
+	if (!inBounds(x, y))
+		return;
+	int cell = y * m_width + x;
+	if (m_blocked.test(cell) == blocked)
+		return;
+	m_blocked.set(x, y, blocked);
+
+	if (!m_valid)
+		return;
+	if (cell == m_target){
+		//Everything hangs off the target, so there is nothing local to repair
+		search();
+		return;
+	}
+	m_repairs++;
+	if (blocked)
+		repairClosed(cell);
+	else
+		repairOpened(cell);
+}
+
+void DistanceField::setTarget(int x, int y){
+	int target = inBounds(x, y) ? y * m_width + x : -1;
+	if (m_valid && target == m_target)
+		return;
+	m_target = target;
+	search();
+}
+
+void DistanceField::setDepthLimit(int depthLimit){
+	if (depthLimit < 0)
+		depthLimit = 0;
+	if (depthLimit != m_depthLimit){
+		m_depthLimit = depthLimit;
+		m_valid = false;
+	}
+}
+
+//Private
+int DistanceField::getNeighbors(int cell, int neighbors[4]) const{
+	int x = cell % m_width, y = cell / m_width;
+	int count = 0;
+	if (y + 1 < m_height)
+		neighbors[count++] = cell + m_width;
+	if (y - 1 >= 0)
+		neighbors[count++] = cell - m_width;
+	if (x - 1 >= 0)
+		neighbors[count++] = cell - 1;
+	if (x + 1 < m_width)
+		neighbors[count++] = cell + 1;
+	return count;
+}
+
+void DistanceField::search(){
+	m_fullSearches++;
+	m_valid = true;
+	m_dist.assign(m_width * m_height, UNREACHABLE);
+	//A target standing somewhere impassable can't be reached from anywhere
+	if (m_target < 0 || m_blocked.test(m_target))
+		return;
+
+	//Breadth-first search a whole ring at a time: the next ring is every open,
+	//unreached cell next to the current one, found with shifts and masks over
+	//the packed board rather than a queue of single cells
+	m_unreached.setAll();
+	m_unreached.andNot(m_blocked);
+	m_unreached.set(m_target % m_width, m_target / m_width, false);
+	m_frontier.clear();
+	m_frontier.set(m_target % m_width, m_target / m_width);
+	m_dist[m_target] = 0;
+	m_cellsExpanded++;
+	for (int dist = 1; dist <= m_depthLimit; dist++){
+		m_next.spreadFrom(m_frontier);
+		m_next &= m_unreached;
+		if (!m_next.any())
+			break;
+		m_unreached.andNot(m_next);
+		for (int i = 0; i < m_next.getNumWords(); i++){
+			for (uint64_t word = m_next.getWord(i); word != 0; word &= word - 1){
+				m_dist[i * 64 + Bitboard::lowestBit(word)] = dist;
+				m_cellsExpanded++;
+			}
+		}
+		m_frontier.swap(m_next);
+	}
+}
+
+//A cell opened up: it can only make distances shorter. Give it the best of
+//its neighbors plus one, then spread any improvement outward. Starting from
+//a single cell, a first-in first-out queue visits cells in order of their
+//new distance, so each cell is settled the first time it improves.
+void DistanceField::repairOpened(int cell){
+	int neighbors[4];
+	int numNeighbors = getNeighbors(cell, neighbors);
+	int best = UNREACHABLE;
+	for (int i = 0; i < numNeighbors; i++)
+		if (!m_blocked.test(neighbors[i]) && m_dist[neighbors[i]] != UNREACHABLE && m_dist[neighbors[i]] + 1 < best)
+			best = m_dist[neighbors[i]] + 1;
+	if (best > m_depthLimit)
+		best = UNREACHABLE;
+	m_dist[cell] = best;
+	if (best == UNREACHABLE)
+		return;  //opened into a walled-off pocket, or too far out to matter
+	m_cellsExpanded++;
+
+	m_queue.clear();
+	m_queue.push_back(cell);
+	for (size_t head = 0; head < m_queue.size(); head++){
+		int current = m_queue[head];
+		numNeighbors = getNeighbors(current, neighbors);
+		for (int i = 0; i < numNeighbors; i++){
+			int next = neighbors[i];
+			if (!m_blocked.test(next) && m_dist[next] > m_dist[current] + 1 && m_dist[current] + 1 <= m_depthLimit){
+				m_dist[next] = m_dist[current] + 1;
+				m_queue.push_back(next);
+				m_cellsExpanded++;
+			}
+		}
+	}
+}
+
+//A cell closed: distances can only get longer, and only for cells whose
+//every shortest path ran through it. Find those cells layer by layer (a cell
+//at distance d survives if some neighbor at d - 1 survives), then re-derive
+//their distances from the unaffected cells around them.
+void DistanceField::repairClosed(int cell){
+	int oldDist = m_dist[cell];
+	m_dist[cell] = UNREACHABLE;
+	if (oldDist == UNREACHABLE)
+		return;  //nothing could have been routed through it
+
+	//Generation counters let m_mark be reused without clearing it
+	if (++m_generation == 0){
+		m_mark.assign(m_mark.size(), 0);
+		m_generation = 1;
+	}
+	unsigned int affected = m_generation;
+
+	//Collect the affected cells into m_queue, in order of their old distance
+	m_queue.clear();
+	int neighbors[4];
+	int numNeighbors = getNeighbors(cell, neighbors);
+	vector<int> candidates;
+	for (int i = 0; i < numNeighbors; i++)
+		if (!m_blocked.test(neighbors[i]) && m_dist[neighbors[i]] == oldDist + 1)
+			candidates.push_back(neighbors[i]);
+	for (size_t head = 0; head < candidates.size(); head++){
+		int current = candidates[head];
+		if (m_mark[current] == affected)
+			continue;  //already settled
+		bool supported = false;
+		numNeighbors = getNeighbors(current, neighbors);
+		for (int i = 0; i < numNeighbors && !supported; i++){
+			int prev = neighbors[i];
+			supported = !m_blocked.test(prev) && m_mark[prev] != affected && m_dist[prev] == m_dist[current] - 1;
+		}
+		if (supported)
+			continue;
+		m_mark[current] = affected;
+		m_queue.push_back(current);
+		for (int i = 0; i < numNeighbors; i++)
+			if (!m_blocked.test(neighbors[i]) && m_dist[neighbors[i]] == m_dist[current] + 1)
+				candidates.push_back(neighbors[i]);
+	}
+
+	//Seed each affected cell from its unaffected neighbors, then settle them
+	//cheapest first
+	typedef pair<int, int> DistAndCell;
+	priority_queue<DistAndCell, vector<DistAndCell>, greater<DistAndCell> > frontier;
+	for (size_t k = 0; k < m_queue.size(); k++){
+		int current = m_queue[k];
+		int best = UNREACHABLE;
+		numNeighbors = getNeighbors(current, neighbors);
+		for (int i = 0; i < numNeighbors; i++){
+			int prev = neighbors[i];
+			if (!m_blocked.test(prev) && m_mark[prev] != affected && m_dist[prev] != UNREACHABLE && m_dist[prev] + 1 < best)
+				best = m_dist[prev] + 1;
+		}
+		if (best > m_depthLimit)
+			best = UNREACHABLE;
+		m_dist[current] = best;
+		if (best != UNREACHABLE)
+			frontier.push(DistAndCell(best, current));
+	}
+	while (!frontier.empty()){
+		DistAndCell top = frontier.top();
+		frontier.pop();
+		if (top.first != m_dist[top.second])
+			continue;  //stale entry
+		m_cellsExpanded++;
+		numNeighbors = getNeighbors(top.second, neighbors);
+		for (int i = 0; i < numNeighbors; i++){
+			int next = neighbors[i];
+			if (m_mark[next] == affected && m_dist[next] > top.first + 1 && top.first + 1 <= m_depthLimit){
+				m_dist[next] = top.first + 1;
+				frontier.push(DistAndCell(top.first + 1, next));
+			}
+		}
+	}
+}
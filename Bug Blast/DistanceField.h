@@ -0,0 +1,92 @@
+#ifndef DISTANCEFIELD_H_
+#define DISTANCEFIELD_H_
+
+#include "GameConstants.h"
+#include "Bitboard.h"
+#include <vector>
+#include <climits>
+
+//=================================================
+//Walking distance from every open cell of the board to one target cell.
+//Since every ComplexZumi chases the same player, one breadth-first search
+//from the player answers all of their "how far is it from here?" questions.
+//
+//The field keeps its own map of blocked cells. When a cell opens up or
+//closes, only the distances that actually change are repaired; only a move
+//of the target itself (which can change every distance) costs a full search.
+//
+//With a depth limit, the search stops that many steps out and anything
+//further away counts as unreachable, so the cost follows the limit rather
+//than the size of the board.
+class DistanceField{
+public:
+	static const int UNREACHABLE = INT_MAX;
+
+	DistanceField(int width = VIEW_WIDTH, int height = VIEW_HEIGHT);
+
+	//Forget everything: every cell open, no target, nothing computed
+	void reset();
+
+	//Mark a cell as impassable or not, repairing the distances around it if
+	//they have already been computed
+	void setBlocked(int x, int y, bool blocked);
+
+	//Make (x, y) the target, searching from scratch if it moved
+	void setTarget(int x, int y);
+
+	//Only look this many steps out from the target (UNREACHABLE for no limit)
+	void setDepthLimit(int depthLimit);
+
+	//Steps from (x, y) to the target, or UNREACHABLE if (x, y) is off the
+	//board, blocked, walled off from the target or beyond the depth limit
+	int distanceFrom(int x, int y) const{
+		if (!inBounds(x, y))
+			return UNREACHABLE;
+		return m_dist[y * m_width + x];
+	}
+
+	//How many times each kind of update has run, for profiling
+	unsigned long getFullSearches() const{
+		return m_fullSearches;
+	}
+	unsigned long getRepairs() const{
+		return m_repairs;
+	}
+	//Cells given a distance by searches and repairs
+	unsigned long getCellsExpanded() const{
+		return m_cellsExpanded;
+	}
+
+private:
+	bool inBounds(int x, int y) const{
+		return x >= 0 && x < m_width && y >= 0 && y < m_height;
+	}
+	int getNeighbors(int cell, int neighbors[4]) const;
+	void search();
+	void repairOpened(int cell);
+	void repairClosed(int cell);
+
+	int m_width;
+	int m_height;
+	int m_target;		//cell index, or -1 if there is none yet
+	bool m_valid;		//m_dist matches m_blocked, m_target and m_depthLimit
+	int m_depthLimit;
+	std::vector<int> m_dist;
+	Bitboard m_blocked;
+
+	//Full searches flood a whole ring of cells at a time
+	Bitboard m_unreached;	//open cells not yet given a distance
+	Bitboard m_frontier;
+	Bitboard m_next;
+
+	//Scratch space, kept between calls to avoid reallocating
+	std::vector<int> m_queue;
+	std::vector<unsigned int> m_mark;
+	unsigned int m_generation;
+
+	unsigned long m_fullSearches;
+	unsigned long m_repairs;
+	unsigned long m_cellsExpanded;
+};
+
+#endif // DISTANCEFIELD_H_
@@ -14,6 +14,7 @@ const int IID_WALK_THRU_GOODIE = 7;
 const int IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE = 8;
 const int IID_PERMA_BRICK      = 9;
 const int IID_DESTROYABLE_BRICK= 10;
+const int IID_INCREASE_SPRAY_RADIUS_GOODIE = 11;
 
 // sounds
 
@@ -32,11 +33,23 @@ const int KEY_PRESS_UP    = 1002;
 const int KEY_PRESS_DOWN  = 1003;
 const int KEY_PRESS_SPACE = ' ';
 
-// board dimensions 
+// board dimensions: the part of the board on screen at once, which is also
+// the size of a board whose level file does not say otherwise
 
 const int VIEW_WIDTH  = 15;
 const int VIEW_HEIGHT = 15;
 
+// the largest board a level file may ask for
+
+const int MAX_BOARD_WIDTH  = 1024;
+const int MAX_BOARD_HEIGHT = 1024;
+
+// the occupancy grid is stored in square chunks this many cells on a side,
+// so that its empty parts cost next to nothing
+
+const int BOARD_CHUNK_SHIFT = 5;
+const int BOARD_CHUNK_SIZE  = 1 << BOARD_CHUNK_SHIFT;
+
 // status of each tick (did the player die?)
 
 const int GWSTATUS_PLAYER_DIED   = 0;
@@ -34,6 +34,10 @@ static const double VISIBLE_MAX_Y = 2;
 static const double VISIBLE_MIN_Z = -20;
 static const double VISIBLE_MAX_Z = -6;
 
+  // The board cell drawn at the bottom left of the window this frame
+static double s_viewOriginX = 0;
+static double s_viewOriginY = 0;
+
 static const double FONT_SCALEDOWN = 760.0;
 
 static const int WINDOW_WIDTH = 1024;
@@ -75,6 +79,7 @@ void GameController::initDrawersAndSounds()
 		make_pair(IID_EXTRA_LIFE_GOODIE ,&drawGoodie),
 		make_pair(IID_WALK_THRU_GOODIE  , &drawGoodie),
 		make_pair(IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE  , &drawGoodie),
+		make_pair(IID_INCREASE_SPRAY_RADIUS_GOODIE  , &drawGoodie),
 		make_pair(IID_PERMA_BRICK      , &drawPermaBrick),
 		make_pair(IID_DESTROYABLE_BRICK, &drawDestroyableBrick),
 	};
@@ -124,6 +129,7 @@ void GameController::run(GameWorld* gw, int testParams[], string windowTitle)
 {
 	gw->setTestParams(testParams);
 	gw->setController(this);
+	gw->setPausesBetweenLevels(true);  // the "finished level" prompt
 	m_gw = gw;
 	m_gameState = welcome;
 	m_lastKeyHit = INVALID_KEY;
@@ -303,13 +309,23 @@ void GameController::displayGamePlay()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
 	
-	std::set<GraphObject*>& graphObjects = GraphObject::getGraphObjects();
-	for (std::set<GraphObject*>::iterator it = graphObjects.begin(); it != graphObjects.end(); it++)
+	m_gw->getViewOrigin(s_viewOriginX, s_viewOriginY);
+
+	GraphObjectRegistry& graphObjects = *m_gw->getGraphObjects();
+	for (GraphObjectRegistry::iterator it = graphObjects.begin(); it != graphObjects.end(); it++)
 	{
 		GraphObject* cur = *it;
 		if (cur->isVisible())
 		{
 			cur->animate();
+
+			  // Only what is in view (or half in view) on a big board
+			double x, y;
+			cur->getAnimationLocation(x, y);
+			if (x <= s_viewOriginX - 1  ||  x >= s_viewOriginX + VIEW_WIDTH  ||
+				y <= s_viewOriginY - 1  ||  y >= s_viewOriginY + VIEW_HEIGHT)
+				continue;
+
 			DrawMapType::const_iterator p = m_drawMap.find(cur->getID());
 			if (p != m_drawMap.end())
 				(*p->second)(cur);  // draw routine for the current object
@@ -332,6 +348,8 @@ void GameController::reshape (int w, int h)
 
 static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
 {
+	x -= s_viewOriginX;
+	y -= s_viewOriginY;
 	x /= VIEW_WIDTH;
 	y /= VIEW_HEIGHT;
 	gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
@@ -629,6 +647,7 @@ static void drawGoodie(GraphObject* go)
 		case IID_EXTRA_LIFE_GOODIE: goodieChar[0] = 'X'; break;
 		case IID_WALK_THRU_GOODIE:  goodieChar[0] = 'W'; break;
 		case IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE:   goodieChar[0] = 'S'; break;
+		case IID_INCREASE_SPRAY_RADIUS_GOODIE:   goodieChar[0] = 'R'; break;
 	}
 	
 	outputStroke(gx, gy, gz, 1, goodieChar);
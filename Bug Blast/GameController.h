@@ -1,6 +1,7 @@
 #ifndef GAMECONTROLLER_H_
 #define GAMECONTROLLER_H_
 
+#include "GameHost.h"
 #include <string>
 #include <map>
 #include <iostream>
@@ -10,17 +11,15 @@ enum GC_STATE {
 	welcome, contgame, finishedlevel, init, cleanup, makemove, animate, gameover, prompt, quit, not_applicable
 };
 
-const int INVALID_KEY = 0;
-
 class GraphObject;
 class GameWorld;
 
-class GameController
+class GameController : public GameHost
 {
   public:
 	void run(GameWorld* gw, int testParams[], std::string windowTitle);
 
-	bool getLastKey(int& value)
+	virtual bool getLastKey(int& value)
 	{
 		if (m_lastKeyHit != INVALID_KEY)
 		{
@@ -34,9 +33,9 @@ class GameController
 	void keyboardEvent(unsigned char key, int x, int y);
 	void specialKeyboardEvent(int key, int x, int y);
     
-	void playSound(int soundID);
+	virtual void playSound(int soundID);
 
-	void setGameStatText(std::string text)
+	virtual void setGameStatText(std::string text)
 	{
 		m_gameStatText = text;
 	}
@@ -0,0 +1,23 @@
+#ifndef GAMEHOST_H_
+#define GAMEHOST_H_
+
+#include <string>
+
+const int INVALID_KEY = 0;
+
+  // The services a GameWorld needs from whatever is driving it.  The
+  // windowed GameController is one host; HeadlessDriver is another.
+
+class GameHost
+{
+  public:
+	virtual ~GameHost()
+	{
+	}
+
+	virtual bool getLastKey(int& value) = 0;
+	virtual void playSound(int soundID) = 0;
+	virtual void setGameStatText(std::string text) = 0;
+};
+
+#endif // GAMEHOST_H_
@@ -1,5 +1,5 @@
 #include "GameWorld.h"
-#include "GameController.h"
+#include "GameHost.h"
 #include <string>
 #include <cstdlib>
 using namespace std;
@@ -11,6 +11,9 @@ bool GameWorld::getKey(int& value)
 	if (gotKey && (value == 'q' || value == '\x03'))  // CTRL-C
 		exit(0);
 
+	if (gotKey && m_tickObserver != NULL)
+		m_tickObserver->keyRead(value);
+
 	return gotKey;
 }
 
@@ -2,18 +2,36 @@
 #define GAMEWORLD_H_
 
 #include "GameConstants.h"
+#include "GraphObject.h"
 #include <string>
+#include <cstdint>
 
 const int START_PLAYER_LIVES = 3;
 
-class GameController;
+class GameHost;
+
+  // Watches a world tick by tick: told about every key the world reads and
+  // about the end of every move(), with a hash of the resulting state.
+  // Replay recording and verification are built on this.
+
+class TickObserver
+{
+  public:
+	virtual ~TickObserver()
+	{
+	}
+
+	virtual void keyRead(int key) = 0;
+	virtual void tickEnded(uint64_t stateHash) = 0;
+};
 
 class GameWorld
 {
 public:
 
 	GameWorld()
-     : m_lives(START_PLAYER_LIVES), m_score(0), m_level(0), m_controller(NULL)
+     : m_lives(START_PLAYER_LIVES), m_score(0), m_level(0), m_controller(NULL),
+	   m_tracksGraphObjects(true), m_pausesBetweenLevels(false), m_tickObserver(NULL)
 	{
 	}
 
@@ -25,6 +43,32 @@ public:
 	virtual int move() = 0;
 	virtual void cleanUp() = 0;
 
+	  // The size of the current level's board, in cells
+	virtual int getBoardWidth() const
+	{
+		return VIEW_WIDTH;
+	}
+
+	virtual int getBoardHeight() const
+	{
+		return VIEW_HEIGHT;
+	}
+
+	  // The cell at the bottom left of the VIEW_WIDTH by VIEW_HEIGHT part
+	  // of the board that gets drawn; worlds with bigger boards move it
+	  // to keep the action on screen.
+	virtual void getViewOrigin(double& x, double& y) const
+	{
+		x = 0;
+		y = 0;
+	}
+
+	  // Worlds that use randomness should make the same seed give the
+	  // same game.
+	virtual void setSeed(uint64_t /* seed */)
+	{
+	}
+
 	void setGameStatText(std::string text);
 
 	bool getKey(int& value);
@@ -86,11 +130,66 @@ public:
 	{
 		++m_level;
 	}
+
+	void startAtLevel(unsigned int level)
+	{
+		m_level = level;
+	}
    
-	void setController(GameController* controller)
+	void setController(GameHost* controller)
 	{
 		m_controller = controller;
 	}
+
+	  // The registry new actors should add themselves to, or NULL if this
+	  // world is never drawn.  Only change tracking between levels.
+	GraphObjectRegistry* getGraphObjects()
+	{
+		return m_tracksGraphObjects ? &m_graphObjects : NULL;
+	}
+
+	  // Forget every registered object at once, for a world that is about
+	  // to throw its actors away without running their destructors.
+	void clearGraphObjects()
+	{
+		m_graphObjects.clear();
+	}
+
+	  // Trade registries with other, to take over a level it built.  Every
+	  // object that changed hands must then be given its new registry.
+	void swapGraphObjects(GameWorld& other)
+	{
+		m_graphObjects.swap(other.m_graphObjects);
+	}
+
+	  // Set by a host that waits (e.g., on a "finished level" prompt)
+	  // between a move() that finishes a level and the next init(), which
+	  // a world may use to get the next level ready.  Hosts that go
+	  // straight on leave it false.
+	void setPausesBetweenLevels(bool pauses)
+	{
+		m_pausesBetweenLevels = pauses;
+	}
+
+	bool pausesBetweenLevels() const
+	{
+		return m_pausesBetweenLevels;
+	}
+
+	void setTracksGraphObjects(bool tracks)
+	{
+		m_tracksGraphObjects = tracks;
+	}
+
+	void setTickObserver(TickObserver* observer)
+	{
+		m_tickObserver = observer;
+	}
+
+	TickObserver* getTickObserver() const
+	{
+		return m_tickObserver;
+	}
     
 	void setTestParams(int testParams[])
 	{
@@ -102,7 +201,11 @@ private:
 	unsigned int	m_lives;
 	unsigned int	m_score;
 	unsigned int	m_level;
-	GameController* m_controller;
+	GameHost*		m_controller;
+	GraphObjectRegistry m_graphObjects;
+	bool			m_tracksGraphObjects;
+	bool			m_pausesBetweenLevels;
+	TickObserver*	m_tickObserver;
 	//int				m_testParams[NUM_TEST_PARAMS];
 };
 
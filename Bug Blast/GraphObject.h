@@ -13,20 +13,38 @@ inline int roundAwayFromZero(double r)
 	 // If C99 is available, this can be return std::round(r);
 }
 
+class GraphObject;
+
+  // The objects a GameController draws each frame.  Every GameWorld owns
+  // its own, so worlds running on different threads never share one.
+typedef std::set<GraphObject*> GraphObjectRegistry;
+
 class GraphObject
 {
   public:
-	GraphObject(int imageID, int startX, int startY)
+	  // A null registry means nobody will ever draw this object (e.g., in a
+	  // headless run), so there is nothing to register with.
+	GraphObject(int imageID, int startX, int startY, GraphObjectRegistry* registry)
 	 : m_imageID(imageID), m_visible(false), m_x(startX), m_y(startY),
 	   m_destX(startX), m_destY(startY), m_brightness(1.0),
-	   m_animationNumber(0)
+	   m_animationNumber(0), m_registry(registry)
 	{
-		getGraphObjects().insert(this);
+		if (m_registry != NULL)
+			m_registry->insert(this);
 	}
 
 	virtual ~GraphObject()
 	{
-		getGraphObjects().erase(this);
+		if (m_registry != NULL)
+			m_registry->erase(this);
+	}
+
+	  // Only for an object whose whole registry has been handed to another
+	  // world (see GameWorld::swapGraphObjects): points it at the registry
+	  // it now lives in, without registering it again.
+	void setRegistry(GraphObjectRegistry* registry)
+	{
+		m_registry = registry;
 	}
 
 	void setVisible(bool shouldIDisplay)
@@ -92,12 +110,6 @@ class GraphObject
 		moveALittle(m_y, m_destY);
 	}
 
-	static std::set<GraphObject*>& getGraphObjects()
-	{
-		static std::set<GraphObject*> graphObjects;
-		return graphObjects;
-	}
-
   private:
 	  // Prevent copying or assigning GraphObjects
 	GraphObject(const GraphObject&);
@@ -111,6 +123,7 @@ class GraphObject
 	double m_destY;
 	double m_brightness;
 	int    m_animationNumber;
+	GraphObjectRegistry* m_registry;
 
 	void moveALittle(double& from, double& to)
 	{
@@ -0,0 +1,85 @@
+#include "HeadlessDriver.h"
+#include "GameWorld.h"
+#include "GameConstants.h"
+#include <chrono>
+using namespace std;
+
+bool RandomKeySource::nextKey(int& value)
+{
+	static const int keys[] = {
+		KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_DOWN, KEY_PRESS_SPACE
+	};
+
+	if (m_random.nextInt(100) < m_percentIdle)
+		return false;
+	value = keys[m_random.nextInt(sizeof(keys)/sizeof(keys[0]))];
+	return true;
+}
+
+HeadlessDriver::HeadlessDriver(GameWorld* gw, KeySource* keys)
+ : m_gw(gw), m_keys(keys), m_pendingKey(INVALID_KEY)
+{
+	m_gw->setController(this);
+	m_gw->setTracksGraphObjects(false);  // nothing is ever drawn
+}
+
+bool HeadlessDriver::getLastKey(int& value)
+{
+	if (m_pendingKey != INVALID_KEY)
+	{
+		value = m_pendingKey;
+		m_pendingKey = INVALID_KEY;
+		return true;
+	}
+	return false;
+}
+
+HeadlessStats HeadlessDriver::run(unsigned long maxTicks)
+{
+	HeadlessStats stats;
+	stats.ticks = 0;
+	stats.levelsCompleted = 0;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	int result = m_gw->init();
+	for (;;)
+	{
+		if (result != GWSTATUS_CONTINUE_GAME)
+			break;  // won, no first level, or a bad level file; nothing to clean up
+
+		while (result == GWSTATUS_CONTINUE_GAME  &&  (maxTicks == 0  ||  stats.ticks < maxTicks))
+		{
+			  // A key nobody reads during its tick is dropped, so what the
+			  // world sees depends only on the key source, not on timing.
+			int key;
+			m_pendingKey = m_keys->nextKey(key) ? key : INVALID_KEY;
+			result = m_gw->move();
+			m_pendingKey = INVALID_KEY;
+			stats.ticks++;
+		}
+
+		if (result == GWSTATUS_FINISHED_LEVEL)
+		{
+			m_gw->advanceToNextLevel();
+			stats.levelsCompleted++;
+		}
+		else if (result != GWSTATUS_PLAYER_DIED  ||  m_gw->isGameOver())
+		{
+			m_gw->cleanUp();
+			break;  // out of ticks or out of lives
+		}
+
+		m_gw->cleanUp();
+		result = m_gw->init();
+	}
+
+	chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+	stats.seconds = chrono::duration<double>(stop - start).count();
+	stats.lastStatus = result;
+	stats.finalLevel = m_gw->getLevel();
+	stats.finalScore = m_gw->getScore();
+	stats.finalLives = m_gw->getLives();
+	return stats;
+}
@@ -0,0 +1,126 @@
+#ifndef HEADLESSDRIVER_H_
+#define HEADLESSDRIVER_H_
+
+#include "GameHost.h"
+#include "RandomGenerator.h"
+#include <string>
+#include <vector>
+
+class GameWorld;
+
+  // Where a headless run gets its keys from.  nextKey is asked once per
+  // tick; returning false means no key was pressed during that tick.
+
+class KeySource
+{
+  public:
+	virtual ~KeySource()
+	{
+	}
+
+	virtual bool nextKey(int& value) = 0;
+};
+
+class NoKeySource : public KeySource
+{
+  public:
+	virtual bool nextKey(int& /* value */)
+	{
+		return false;
+	}
+};
+
+  // Plays back a fixed list of keys, one per tick; INVALID_KEY entries
+  // mean "no key this tick".  After the script runs out, no more keys.
+
+class ScriptedKeySource : public KeySource
+{
+  public:
+	ScriptedKeySource(const std::vector<int>& keys)
+	 : m_keys(keys), m_next(0)
+	{
+	}
+
+	virtual bool nextKey(int& value)
+	{
+		if (m_next >= m_keys.size())
+			return false;
+		value = m_keys[m_next++];
+		return value != INVALID_KEY;
+	}
+
+  private:
+	std::vector<int> m_keys;
+	size_t			 m_next;
+};
+
+  // A monkey bot: each tick it presses a random direction or drops a
+  // sprayer, idling the rest of the time.  It owns its generator, so two
+  // of them never share state; give it a split() of the world's stream to
+  // make a whole game reproducible from one seed.
+
+class RandomKeySource : public KeySource
+{
+  public:
+	RandomKeySource(const RandomGenerator& generator, int percentIdle = 50)
+	 : m_random(generator), m_percentIdle(percentIdle)
+	{
+	}
+
+	virtual bool nextKey(int& value);
+
+  private:
+	RandomGenerator m_random;
+	int				m_percentIdle;
+};
+
+struct HeadlessStats
+{
+	unsigned long	ticks;
+	unsigned int	levelsCompleted;
+	unsigned int	finalLevel;
+	unsigned int	finalScore;
+	unsigned int	finalLives;
+	int				lastStatus;
+	double			seconds;
+
+	double ticksPerSecond() const
+	{
+		return seconds > 0 ? ticks / seconds : 0;
+	}
+
+	double nsPerTick() const
+	{
+		return ticks > 0 ? seconds * 1e9 / ticks : 0;
+	}
+};
+
+  // Runs a GameWorld through init/move/cleanUp as fast as possible, with
+  // no window, no animation frames, no prompts and no sound.
+
+class HeadlessDriver : public GameHost
+{
+  public:
+	HeadlessDriver(GameWorld* gw, KeySource* keys);
+
+	  // Play until the game is over, won, fails to load, or maxTicks calls
+	  // to move() have been made (0 means no limit).
+	HeadlessStats run(unsigned long maxTicks = 0);
+
+	virtual bool getLastKey(int& value);
+
+	virtual void playSound(int /* soundID */)
+	{
+	}
+
+	virtual void setGameStatText(std::string /* text */)
+	{
+	}
+
+  private:
+	GameWorld*	m_gw;
+	KeySource*	m_keys;
+	int			m_pendingKey;
+};
+
+#endif // HEADLESSDRIVER_H_
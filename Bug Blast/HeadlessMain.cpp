@@ -0,0 +1,293 @@
+  // Entry point for the headless runner.  Build it from GameWorld.cpp,
+  // StudentWorld.cpp, Actor.cpp, DistanceField.cpp, BlastEngine.cpp,
+  // CompiledLevel.cpp, LevelPack.cpp, HeadlessDriver.cpp,
+  // BatchSimulator.cpp, Replay.cpp and this file; it does not need
+  // GameController.cpp, main.cpp, GLUT, OpenGL or irrKlang.
+  //
+  //   usage: bugblast-headless [-ticks N] [-keys none|random] [-seed S] [-level L] [-record FILE]
+  //                            [-batch GAMES [-threads T] [-scaling]]
+  //                            [-replay FILE] [-pack FILE]
+  //
+  // With -batch, plays GAMES random-bot games (seeds S, S+1, ...) across T
+  // threads and reports aggregate results; -scaling repeats the batch with
+  // 1, 2, 4, ... T threads.  -record saves a single game for -replay, which
+  // plays it back at full speed and checks the world state after every tick.
+  // -pack takes every level from one level pack (see LevelPack.h) instead of
+  // the levelNN files in the current directory.
+
+#include "HeadlessDriver.h"
+#include "BatchSimulator.h"
+#include "Replay.h"
+#include "LevelPack.h"
+#include "StudentWorld.h"
+#include "GameConstants.h"
+#include "Actor.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+using namespace std;
+
+static const char* statusName(int status)
+{
+	switch (status)
+	{
+		case GWSTATUS_PLAYER_DIED:    return "game over";
+		case GWSTATUS_CONTINUE_GAME:  return "tick limit reached";
+		case GWSTATUS_PLAYER_WON:     return "player won";
+		case GWSTATUS_NO_FIRST_LEVEL: return "cannot find first level data file";
+		case GWSTATUS_LEVEL_ERROR:    return "error in level data file encoding";
+		default:                      return "unknown";
+	}
+}
+
+static const char* causeName(int cause)
+{
+	switch (cause)
+	{
+		case CAUSE_ZUMI:      return "zumi";
+		case CAUSE_BUG_SPRAY: return "bug spray";
+		case CAUSE_BRICK:     return "brick";
+		default:              return "none";
+	}
+}
+
+static void usage(const char* progName)
+{
+	string indent(string(progName).size(), ' ');
+	cerr << "usage: " << progName << " [-ticks N] [-keys none|random] [-seed S] [-level L] [-record FILE]" << endl;
+	cerr << "       " << indent << " [-batch GAMES [-threads T] [-scaling]]" << endl;
+	cerr << "       " << indent << " [-replay FILE] [-pack FILE]" << endl;
+	exit(1);
+}
+
+static void printStats(const HeadlessStats& stats)
+{
+	cout << "result:    " << statusName(stats.lastStatus) << endl;
+	cout << "ticks:     " << stats.ticks << " in " << stats.seconds << " s" << endl;
+	cout << "levels:    " << stats.levelsCompleted << " completed, ended on level " << stats.finalLevel << endl;
+	cout << "score:     " << stats.finalScore << "  lives: " << stats.finalLives << endl;
+	cout << "ticks/sec: " << stats.ticksPerSecond() << endl;
+	cout << "ns/tick:   " << stats.nsPerTick() << endl;
+}
+
+static void runSingle(unsigned long maxTicks, const string& keyMode, uint64_t seed, unsigned int startLevel,
+					  const string& recordFile, const LevelPack* pack)
+{
+	  // As in a batch job, one seed drives both the world and the bot.  The
+	  // world's half of the split is exactly RandomGenerator(seed), which is
+	  // what a replay will give it back.
+	RandomGenerator streams(seed);
+	StudentWorld world;
+	world.setRandomGenerator(streams.split());
+	world.startAtLevel(startLevel);
+	world.setLevelPack(pack);
+
+	ReplayRecorder recorder;
+	if (!recordFile.empty())
+	{
+		if (!recorder.open(recordFile, seed, startLevel, pack != NULL ? pack->getChecksum() : 0))
+		{
+			cerr << "Cannot write " << recordFile << endl;
+			exit(1);
+		}
+		world.setTickObserver(&recorder);
+	}
+
+	KeySource* keys = NULL;
+	if (keyMode == "none")
+		keys = new NoKeySource;
+	else
+		keys = new RandomKeySource(streams.split());
+
+	HeadlessDriver driver(&world, keys);
+	HeadlessStats stats = driver.run(maxTicks);
+	delete keys;
+
+	printStats(stats);
+	const DistanceField& paths = world.getPlayerDistances();
+	cout << "pathing:   " << paths.getFullSearches() << " searches, " << paths.getRepairs() << " repairs, "
+		 << paths.getCellsExpanded() << " cells expanded" << endl;
+}
+
+static int runReplay(const string& replayFile, const LevelPack* pack)
+{
+	Replay replay;
+	if (!replay.load(replayFile))
+	{
+		cerr << "Cannot read replay " << replayFile << endl;
+		return 1;
+	}
+	if (replay.keys.empty())
+	{
+		cout << "replay:    empty" << endl;
+		return 0;
+	}
+
+	  // Played on other levels, the game would only show up as a hash
+	  // mismatch somewhere along the way
+	uint32_t levelPack = pack != NULL ? pack->getChecksum() : 0;
+	if (replay.levelPack != levelPack)
+	{
+		if (replay.levelPack == 0)
+			cerr << "Replay was recorded with the levelNN files; run it without -pack" << endl;
+		else if (pack == NULL)
+			cerr << "Replay was recorded with a level pack; run it with the same -pack" << endl;
+		else
+			cerr << "Replay was recorded with a different level pack" << endl;
+		return 1;
+	}
+
+	StudentWorld world;
+	world.setSeed(replay.seed);
+	world.startAtLevel(replay.startLevel);
+	world.setLevelPack(pack);
+
+	ReplayPlayer player(replay);
+	world.setTickObserver(&player);
+	HeadlessDriver driver(&world, &player);
+	HeadlessStats stats = driver.run(replay.keys.size());
+
+	printStats(stats);
+	if (stats.ticks != replay.keys.size()  &&  player.getFirstMismatch() < 0)
+	{
+		cout << "replay:    game ended after " << stats.ticks << " of " << replay.keys.size() << " ticks" << endl;
+		return 2;
+	}
+	if (player.getFirstMismatch() >= 0)
+	{
+		cout << "replay:    diverged at tick " << player.getFirstMismatch() << endl;
+		return 2;
+	}
+	cout << "replay:    all " << stats.ticks << " ticks match" << endl;
+	return 0;
+}
+
+static void printSummary(const BatchSummary& summary)
+{
+	int byStatus[GWSTATUS_LEVEL_ERROR+1] = { 0 };
+	int byCause[CAUSE_BRICK+1] = { 0 };
+	double totalScore = 0;
+	for (size_t k = 0; k < summary.results.size(); k++)
+	{
+		const BatchResult& r = summary.results[k];
+		byStatus[r.status]++;
+		byCause[r.causeOfDeath]++;
+		totalScore += r.score;
+	}
+
+	size_t games = summary.results.size();
+	cout << "games:     " << games << " on " << summary.threads << " threads in " << summary.seconds << " s" << endl;
+	for (int s = 0; s <= GWSTATUS_LEVEL_ERROR; s++)
+		if (byStatus[s] != 0)
+			cout << "  " << statusName(s) << ": " << byStatus[s] << endl;
+	cout << "last death:" << endl;
+	for (int c = 0; c <= CAUSE_BRICK; c++)
+		if (byCause[c] != 0)
+			cout << "  " << causeName(c) << ": " << byCause[c] << endl;
+	cout << "mean score:        " << (games ? totalScore / games : 0) << endl;
+	cout << "mean ticks/game:   " << (games ? double(summary.totalTicks) / games : 0) << endl;
+	cout << "world-ticks/sec:   " << summary.worldTicksPerSecond() << endl;
+}
+
+static void runBatch(unsigned long maxTicks, uint64_t seed, unsigned int startLevel,
+					 unsigned int games, unsigned int threads, bool scaling, const LevelPack* pack)
+{
+	vector<BatchJob> jobs(games);
+	for (unsigned int k = 0; k < games; k++)
+	{
+		jobs[k].startLevel = startLevel;
+		jobs[k].seed = seed + k;
+		jobs[k].maxTicks = maxTicks;
+		jobs[k].levelPack = pack;
+	}
+
+	BatchSimulator simulator(threads);
+	BatchSummary summary = simulator.run(jobs);
+	printSummary(summary);
+
+	if (!scaling)
+		return;
+
+	cout << endl << "threads  world-ticks/sec  speedup" << endl;
+	double base = 0;
+	for (unsigned int t = 1; ; t *= 2)
+	{
+		if (t > summary.threads)
+			t = summary.threads;
+		BatchSummary s = BatchSimulator(t).run(jobs);
+		if (t == 1)
+			base = s.worldTicksPerSecond();
+		cout << t << "  " << s.worldTicksPerSecond() << "  " << (base > 0 ? s.worldTicksPerSecond() / base : 0) << endl;
+		if (t == summary.threads)
+			break;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long maxTicks = 100000;
+	string keyMode = "random";
+	uint64_t seed = 1;
+	unsigned int startLevel = 0;
+	unsigned int games = 0;
+	unsigned int threads = 0;
+	bool scaling = false;
+	string recordFile;
+	string replayFile;
+	string packFile;
+
+	for (int k = 1; k < argc; k++)
+	{
+		string arg = argv[k];
+		if (arg == "-scaling")
+		{
+			scaling = true;
+			continue;
+		}
+		if (k+1 == argc)
+			usage(argv[0]);
+		if (arg == "-ticks")
+			maxTicks = strtoul(argv[++k], NULL, 10);
+		else if (arg == "-keys")
+			keyMode = argv[++k];
+		else if (arg == "-seed")
+			seed = strtoull(argv[++k], NULL, 10);
+		else if (arg == "-level")
+			startLevel = static_cast<unsigned int>(strtoul(argv[++k], NULL, 10));
+		else if (arg == "-batch")
+			games = static_cast<unsigned int>(strtoul(argv[++k], NULL, 10));
+		else if (arg == "-threads")
+			threads = static_cast<unsigned int>(strtoul(argv[++k], NULL, 10));
+		else if (arg == "-record")
+			recordFile = argv[++k];
+		else if (arg == "-replay")
+			replayFile = argv[++k];
+		else if (arg == "-pack")
+			packFile = argv[++k];
+		else
+			usage(argv[0]);
+	}
+
+	  // Mapped once here and shared by every world, whatever the mode
+	LevelPack pack;
+	if (!packFile.empty()  &&  !pack.open(packFile))
+	{
+		cerr << "Cannot read level pack " << packFile << endl;
+		return 1;
+	}
+	const LevelPack* levels = packFile.empty() ? NULL : &pack;
+
+	if (!replayFile.empty())
+		return runReplay(replayFile, levels);
+
+	if (games > 0)
+	{
+		runBatch(maxTicks, seed, startLevel, games, threads, scaling, levels);
+		return 0;
+	}
+
+	if (keyMode != "none"  &&  keyMode != "random")
+		usage(argv[0]);
+	runSingle(maxTicks, keyMode, seed, startLevel, recordFile, levels);
+}
@@ -2,11 +2,13 @@
 #define LEVEL_H_
 
 #include "GameConstants.h"
+#include "RandomGenerator.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <map>
 #include <string>
+#include <vector>
 #include <cctype>
 
 const int INVALID_SETTING = (unsigned int)-1;
@@ -24,9 +26,54 @@ const std::string optionBoostedSprayerLifetimeTicks = "boostedSprayerLifetimeTic
 const std::string optionMaxBoostedSprayers = "maxBoostedSprayers";
 const std::string optionComplexZumiSearchDistance = "complexZumiSearchDistance";
 
+  // Optional; a level file that leaves these out gets the defaults passed
+  // to getOption(option, defaultValue)
+const std::string optionSprayRadius = "sprayRadius";
+const std::string optionProbOfSprayRadiusGoodie = "probOfSprayRadiusGoodie";
+const std::string optionBoardWidth = "boardWidth";    // VIEW_WIDTH if left out
+const std::string optionBoardHeight = "boardHeight";  // VIEW_HEIGHT if left out
+
+  // The same options as indexes into Level's settings table, in the order
+  // of Level::optionName.  Every level file must set the ones before
+  // NUM_REQUIRED_OPTIONS.
+enum LevelOption
+{
+	OPTION_PROB_OF_GOODIE_OVERALL,
+	OPTION_PROB_OF_EXTRA_LIFE_GOODIE,
+	OPTION_PROB_OF_WALK_THRU_GOODIE,
+	OPTION_PROB_OF_MORE_SPRAYERS_GOODIE,
+	OPTION_TICKS_PER_SIMPLE_ZUMI_MOVE,
+	OPTION_TICKS_PER_COMPLEX_ZUMI_MOVE,
+	OPTION_GOODIE_LIFETIME_IN_TICKS,
+	OPTION_LEVEL_BONUS,
+	OPTION_WALK_THRU_LIFETIME_TICKS,
+	OPTION_BOOSTED_SPRAYER_LIFETIME_TICKS,
+	OPTION_MAX_BOOSTED_SPRAYERS,
+	OPTION_COMPLEX_ZUMI_SEARCH_DISTANCE,
+	NUM_REQUIRED_OPTIONS,
+
+	OPTION_SPRAY_RADIUS = NUM_REQUIRED_OPTIONS,
+	OPTION_PROB_OF_SPRAY_RADIUS_GOODIE,
+	OPTION_BOARD_WIDTH,
+	OPTION_BOARD_HEIGHT,
+	NUM_LEVEL_OPTIONS
+};
+
+  // What a dying zumi leaves behind, from Level::rollGoodieDrop
+enum GoodieDrop
+{
+	DROP_NONE,
+	DROP_EXTRA_LIFE,
+	DROP_MORE_SPRAYERS,
+	DROP_WALK_THRU,
+	DROP_SPRAY_RADIUS
+};
+
 class Level
 {
 public:
+	  // Reads and writes the binary form of a level (CompiledLevel.h)
+	friend class CompiledLevel;
 
 	enum MazeEntry {
 		empty, exit, player, simple_zumi, complex_zumi, perma_brick, destroyable_brick
@@ -36,10 +83,12 @@ public:
 	};
 
 	Level()
+	 : m_width(VIEW_WIDTH), m_height(VIEW_HEIGHT), m_maze(VIEW_WIDTH * VIEW_HEIGHT, empty)
 	{
-		for (int i = 0; i < VIEW_HEIGHT; i++)
-			for (int j = 0; j < VIEW_WIDTH; j++)
-				m_maze[i][j] = empty;
+		for (int k = 0; k < NUM_LEVEL_OPTIONS; k++)
+			m_options[k] = INVALID_SETTING;
+		for (int k = 0; k < NUM_GOODIE_KINDS; k++)
+			m_goodieBounds[k] = 0;
 	}
 
 	LoadResult loadLevel(std::string filename, std::string dir = "")
@@ -73,11 +122,22 @@ public:
 				return load_fail_bad_format;
 
 			toUpperStr(optionName);
-			m_settingsMap[optionName] = static_cast<unsigned int>(optionValue);
+			int option = findOption(optionName);
+			if (option != NUM_LEVEL_OPTIONS)
+				m_options[option] = static_cast<unsigned int>(optionValue);
+			else
+				m_settingsMap[optionName] = static_cast<unsigned int>(optionValue);
 		}
 
 		if ( ! allOptionsValid())
 			return load_fail_bad_format;
+		buildGoodieTable();
+
+		  // the options say how big the maze is
+		unsigned int width = getOption(OPTION_BOARD_WIDTH, VIEW_WIDTH);
+		unsigned int height = getOption(OPTION_BOARD_HEIGHT, VIEW_HEIGHT);
+		if (!setSize(width, height))
+			return load_fail_bad_format;
 
 		  // empty line separates options from maze
 		if (line.find_first_not_of(" \t\r") != std::string::npos)
@@ -88,7 +148,7 @@ public:
 		bool foundExit = false;
 		bool foundPlayer = false;
 
-		for (int y = VIEW_HEIGHT-1; std::getline(levelFile, line); y--)
+		for (int y = m_height-1; std::getline(levelFile, line); y--)
 		{
 			if (y < 0)  // too many maze lines?
 			{
@@ -99,10 +159,11 @@ public:
 			    	return load_fail_bad_format;
 				break;
 			}
-			if (line.size() < VIEW_WIDTH  ||  line.find_first_not_of(" \t\r", VIEW_WIDTH) != std::string::npos)
+			if (line.size() < std::string::size_type(m_width)  ||
+				line.find_first_not_of(" \t\r", m_width) != std::string::npos)
 				return load_fail_bad_format;
 				
-			for (int x = 0; x < VIEW_WIDTH; x++)
+			for (int x = 0; x < m_width; x++)
 			{
 				MazeEntry me;
 				switch (tolower(line[x]))
@@ -116,7 +177,7 @@ public:
 					case '#':  me = perma_brick;                break;
 					case '*':  me = destroyable_brick;          break;
 				}
-				m_maze[y][x] = me;
+				m_maze[y * m_width + x] = me;
 			}
 		}
 
@@ -128,46 +189,140 @@ public:
 
 	MazeEntry getContentsOf(unsigned int x, unsigned int y) const
 	{
-		return (x < VIEW_WIDTH && y < VIEW_HEIGHT) ? m_maze[y][x] : empty;
+		if (x >= unsigned(m_width)  ||  y >= unsigned(m_height))
+			return empty;
+		return MazeEntry(m_maze[y * m_width + x]);
 	}
 
+	int getWidth() const
+	{
+		return m_width;
+	}
+
+	int getHeight() const
+	{
+		return m_height;
+	}
+
+	  // The fast way to read an option: no strings involved
+	unsigned int getOption(LevelOption option) const
+	{
+		return m_options[option];
+	}
+
+	unsigned int getOption(LevelOption option, unsigned int defaultValue) const
+	{
+		return (m_options[option] == (unsigned int)INVALID_SETTING) ? defaultValue : m_options[option];
+	}
+
+	  // Rolls whether a zumi drops a goodie (probOfGoodieOverall percent of
+	  // the time) and, if so, which one, weighted by the probOf...Goodie
+	  // options.  The cumulative weights are worked out once, at load.
+	GoodieDrop rollGoodieDrop(RandomGenerator& random) const
+	{
+		if (random.nextInt(100) >= int(m_options[OPTION_PROB_OF_GOODIE_OVERALL]))
+			return DROP_NONE;
+		  // With every weight 0 there is nothing to drop (and nextInt(0)
+		  // would not have drawn a number anyway)
+		if (m_goodieBounds[NUM_GOODIE_KINDS-1] == 0)
+			return DROP_NONE;
+		int roll = random.nextInt(m_goodieBounds[NUM_GOODIE_KINDS-1]);
+		for (int k = 0; k < NUM_GOODIE_KINDS; k++)
+			if (roll < m_goodieBounds[k])
+				return GoodieDrop(DROP_EXTRA_LIFE + k);
+		return DROP_NONE;
+	}
+
+	  // By name, which also finds options the game does not know about
 	unsigned int getOptionValue(std::string forSetting) const
 	{
 		toUpperStr(forSetting);
+		int option = findOption(forSetting);
+		if (option != NUM_LEVEL_OPTIONS)
+			return m_options[option];
 		SettingsMap::const_iterator it = m_settingsMap.find(forSetting);
 		return (it == m_settingsMap.end()) ? INVALID_SETTING : it->second;
 	}
 
+	unsigned int getOptionValue(std::string forSetting, unsigned int defaultValue) const
+	{
+		unsigned int value = getOptionValue(forSetting);
+		return (value == (unsigned int)INVALID_SETTING) ? defaultValue : value;
+	}
+
 private:
 
-	bool optionValid(std::string option) const
+	static const std::string& optionName(int option)
+	{
+		static const std::string names[NUM_LEVEL_OPTIONS] = {
+			optionProbOfGoodieOverall, optionProbOfExtraLifeGoodie, optionProbOfWalkThruGoodie,
+			optionProbOfMoreSprayersGoodie, optionTicksPerSimpleZumiMove, optionTicksPerComplexZumiMove,
+			optionGoodieLifetimeInTicks, optionLevelBonus, optionWalkThruLifetimeTicks,
+			optionBoostedSprayerLifetimeTicks, optionMaxBoostedSprayers, optionComplexZumiSearchDistance,
+			optionSprayRadius, optionProbOfSprayRadiusGoodie, optionBoardWidth, optionBoardHeight
+		};
+		return names[option];
+	}
+
+	  // The LevelOption named upperName (already uppercased), or
+	  // NUM_LEVEL_OPTIONS if there is none
+	static int findOption(const std::string& upperName)
+	{
+		for (int k = 0; k < NUM_LEVEL_OPTIONS; k++)
+		{
+			const std::string& name = optionName(k);
+			if (name.size() != upperName.size())
+				continue;
+			std::string::size_type c = 0;
+			while (c != name.size()  &&  toupper(name[c]) == upperName[c])
+				c++;
+			if (c == name.size())
+				return k;
+		}
+		return NUM_LEVEL_OPTIONS;
+	}
+
+	void buildGoodieTable()
 	{
-		return getOptionValue(option) != INVALID_SETTING;
+		static const LevelOption weights[NUM_GOODIE_KINDS] = {
+			OPTION_PROB_OF_EXTRA_LIFE_GOODIE, OPTION_PROB_OF_MORE_SPRAYERS_GOODIE,
+			OPTION_PROB_OF_WALK_THRU_GOODIE, OPTION_PROB_OF_SPRAY_RADIUS_GOODIE
+		};
+		int total = 0;
+		for (int k = 0; k < NUM_GOODIE_KINDS; k++)
+		{
+			total += int(getOption(weights[k], 0));
+			m_goodieBounds[k] = total;
+		}
 	}
 
 	bool allOptionsValid() const
 	{
-		return optionValid(optionProbOfGoodieOverall) &&
-			   optionValid(optionProbOfExtraLifeGoodie) &&
-			   optionValid(optionProbOfWalkThruGoodie) &&
-			   optionValid(optionProbOfMoreSprayersGoodie) &&
-			   optionValid(optionTicksPerSimpleZumiMove) &&
-			   optionValid(optionTicksPerComplexZumiMove) &&
-			   optionValid(optionGoodieLifetimeInTicks) &&
-			   optionValid(optionLevelBonus) &&
-			   optionValid(optionWalkThruLifetimeTicks) &&
-			   optionValid(optionBoostedSprayerLifetimeTicks) &&
-			   optionValid(optionMaxBoostedSprayers) &&
-			   optionValid(optionComplexZumiSearchDistance);
+		for (int k = 0; k < NUM_REQUIRED_OPTIONS; k++)
+			if (m_options[k] == (unsigned int)INVALID_SETTING)
+				return false;
+		return true;
+	}
+
+	  // An empty maze of this size, if it is a size the game allows
+	bool setSize(unsigned int width, unsigned int height)
+	{
+		if (width < 1  ||  width > unsigned(MAX_BOARD_WIDTH)  ||
+			height < 1  ||  height > unsigned(MAX_BOARD_HEIGHT))
+			return false;
+		m_width = width;
+		m_height = height;
+		m_maze.assign(m_width * m_height, empty);
+		return true;
 	}
 
 	bool edgesValid() const
 	{
-		for (int y = 0; y < VIEW_HEIGHT; y++)
-			if (m_maze[y][0] != perma_brick || m_maze[y][VIEW_WIDTH-1] != perma_brick)
+		for (int y = 0; y < m_height; y++)
+			if (getContentsOf(0, y) != perma_brick || getContentsOf(m_width-1, y) != perma_brick)
 				return false;
-		for (int x = 0; x < VIEW_WIDTH; x++)
-			if (m_maze[0][x] != perma_brick || m_maze[VIEW_HEIGHT-1][x] != perma_brick)
+		for (int x = 0; x < m_width; x++)
+			if (getContentsOf(x, 0) != perma_brick || getContentsOf(x, m_height-1) != perma_brick)
 				return false;
 
 		return true;
@@ -182,8 +337,15 @@ private:
 private:
 	typedef std::map<std::string, unsigned int> SettingsMap;
 
-	MazeEntry   m_maze[VIEW_HEIGHT][VIEW_WIDTH];
-	SettingsMap m_settingsMap;
+	  // One per GoodieDrop after DROP_NONE
+	static const int NUM_GOODIE_KINDS = 4;
+
+	int          m_width;
+	int          m_height;
+	std::vector<unsigned char> m_maze;  // MazeEntry of (x, y) at y * m_width + x
+	unsigned int m_options[NUM_LEVEL_OPTIONS];
+	SettingsMap  m_settingsMap;  // only options the game does not know about
+	int          m_goodieBounds[NUM_GOODIE_KINDS];  // running totals of the weights
 };
 
 #endif // LEVEL_H_
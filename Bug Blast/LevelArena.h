@@ -0,0 +1,85 @@
+#ifndef LEVELARENA_H_
+#define LEVELARENA_H_
+
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <cstddef>
+
+//=================================================
+//Memory for everything that lives exactly as long as one level. Allocation
+//bumps a pointer through big blocks, and release() takes the whole level
+//back at once by rewinding to the first block; the blocks themselves are
+//kept for the next level and only freed with the arena.
+//The arena never runs destructors. Whoever releases it must know that what
+//it held owns nothing else (see StudentWorld::deleteAllActors).
+class LevelArena{
+public:
+	LevelArena(size_t blockSize = 64 * 1024) : m_blockSize(blockSize), m_current(0), m_offset(0){
+	}
+
+	~LevelArena(){
+		for (size_t i = 0; i < m_blocks.size(); i++)
+			::operator delete(m_blocks[i].data);
+	}
+
+	template<typename Type, typename... Args>
+	Type* create(Args... args){
+		return new (allocate(sizeof(Type), alignof(Type))) Type(args...);
+	}
+
+	void* allocate(size_t size, size_t align){
+		while (m_current < m_blocks.size()){
+			size_t start = (m_offset + align - 1) / align * align;
+			if (start + size <= m_blocks[m_current].size){
+				m_offset = start + size;
+				return m_blocks[m_current].data + start;
+			}
+			m_current++;
+			m_offset = 0;
+		}
+
+		//Out of blocks: add one, big enough for this request if it is a big one
+		Block block;
+		block.size = size > m_blockSize ? size : m_blockSize;
+		block.data = static_cast<char*>(::operator new(block.size));
+		m_blocks.push_back(block);
+		m_current = m_blocks.size() - 1;
+		m_offset = size;
+		return block.data;
+	}
+
+	void release(){
+		m_current = 0;
+		m_offset = 0;
+	}
+
+	//Trades blocks with other, along with whatever was built in them
+	void swap(LevelArena& other){
+		std::swap(m_blockSize, other.m_blockSize);
+		m_blocks.swap(other.m_blocks);
+		std::swap(m_current, other.m_current);
+		std::swap(m_offset, other.m_offset);
+	}
+
+	size_t getNumBlocks() const{
+		return m_blocks.size();
+	}
+
+private:
+	struct Block{
+		char* data;
+		size_t size;
+	};
+
+	//Prevent copying: the blocks belong to exactly one arena
+	LevelArena(const LevelArena&);
+	LevelArena& operator=(const LevelArena&);
+
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	size_t m_current;	//the block being bumped through
+	size_t m_offset;	//how much of it is used
+};
+
+#endif // LEVELARENA_H_
@@ -0,0 +1,105 @@
+  // levelc: checks level files once, offline, and writes the binary form
+  // the game loads in their place (see CompiledLevel.h).  Build it from
+  // CompiledLevel.cpp, LevelPack.cpp and this file.
+  //
+  //   usage: levelc FILE.dat...
+  //          levelc -pack PACK.bbp FILE.dat...
+  //
+  // Each FILE.dat that loads cleanly is written out as FILE.bbl next to
+  // it; the game then loads levelNN.bbl instead of levelNN.dat until the
+  // .dat is edited, when it goes back to reading the text.  With
+  // -pack, the files become levels 0, 1, 2, ... of one level pack (see
+  // LevelPack.h) instead, and nothing is written unless all of them
+  // compile.  Exits with status 1 if any file could not be read or
+  // compiled.
+
+#include "CompiledLevel.h"
+#include "LevelPack.h"
+#include "Level.h"
+#include <fstream>
+#include <vector>
+#include <iostream>
+#include <string>
+using namespace std;
+
+static const char* loadError(Level::LoadResult result)
+{
+	switch (result)
+	{
+		case Level::load_fail_file_not_found:  return "cannot open file";
+		case Level::load_fail_bad_format:      return "error in level data file encoding";
+		default:                               return "unknown error";
+	}
+}
+
+static bool writeFile(const string& filename, const vector<char>& data)
+{
+	ofstream out(filename.c_str(), ios::binary);
+	out.write(&data[0], data.size());
+	out.close();
+	return !out.fail();
+}
+
+int main(int argc, char* argv[])
+{
+	string packName;
+	int first = 1;
+	if (argc > 1  &&  string(argv[1]) == "-pack")
+	{
+		if (argc > 2)
+			packName = argv[2];
+		first = 3;
+	}
+	if (first >= argc)
+	{
+		cerr << "usage: " << argv[0] << " FILE.dat..." << endl;
+		cerr << "       " << argv[0] << " -pack PACK" << LevelPack::FILE_EXTENSION << " FILE.dat..." << endl;
+		return 1;
+	}
+
+	int failures = 0;
+	vector<vector<char> > packLevels;
+	for (int k = first; k < argc; k++)
+	{
+		string textName = argv[k];
+		Level level;
+		Level::LoadResult result = level.loadLevel(textName);
+		if (result != Level::load_success)
+		{
+			cerr << textName << ": " << loadError(result) << endl;
+			failures++;
+			continue;
+		}
+
+		if (!packName.empty())
+		{
+			packLevels.push_back(vector<char>());
+			CompiledLevel::compile(level, packLevels.back(),
+								   CompiledLevel::sourceChecksum(textName));
+			continue;
+		}
+
+		string compiledName = CompiledLevel::compiledName(textName);
+		if (!CompiledLevel::save(level, compiledName,
+								 CompiledLevel::sourceChecksum(textName)))
+		{
+			cerr << compiledName << ": cannot write file" << endl;
+			failures++;
+			continue;
+		}
+		cout << textName << " -> " << compiledName << endl;
+	}
+
+	if (!packName.empty()  &&  failures == 0)
+	{
+		vector<char> pack;
+		LevelPack::build(packLevels, pack);
+		if (!writeFile(packName, pack))
+		{
+			cerr << packName << ": cannot write file" << endl;
+			return 1;
+		}
+		cout << packLevels.size() << " levels -> " << packName << endl;
+	}
+	return failures == 0 ? 0 : 1;
+}
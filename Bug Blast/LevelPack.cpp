@@ -0,0 +1,192 @@
+#include "LevelPack.h"
+#include "CompiledLevel.h"
+#include <algorithm>
+#include <cstdint>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+const char* const LevelPack::FILE_EXTENSION = ".bbp";
+
+static const char	  PACK_MAGIC[4] = { 'B', 'B', 'L', 'P' };
+static const uint32_t PACK_VERSION = 1;
+static const size_t	  HEADER_SIZE = 16;
+static const size_t	  INDEX_ENTRY_SIZE = 16;
+
+static void putBytes(vector<char>& out, uint64_t value, int numBytes)
+{
+	for (int k = 0; k < numBytes; k++)
+		out.push_back(static_cast<char>((value >> (8*k)) & 0xff));
+}
+
+static uint64_t getBytes(const char* data, int numBytes)
+{
+	uint64_t value = 0;
+	for (int k = 0; k < numBytes; k++)
+		value |= uint64_t(static_cast<unsigned char>(data[k])) << (8*k);
+	return value;
+}
+
+LevelPack::LevelPack()
+ : m_data(NULL), m_size(0), m_numLevels(0)
+#ifdef _WIN32
+   , m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#endif
+{
+}
+
+LevelPack::~LevelPack()
+{
+	close();
+}
+
+bool LevelPack::open(string filename)
+{
+	close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+						 FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_file, &fileSize)  ||  fileSize.QuadPart < LONGLONG(HEADER_SIZE))
+	{
+		close();
+		return false;
+	}
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping == NULL)
+	{
+		close();
+		return false;
+	}
+	m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0  ||  info.st_size < off_t(HEADER_SIZE))
+	{
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);  // the mapping outlives the descriptor
+	if (mapped != MAP_FAILED)
+	{
+		m_data = static_cast<const char*>(mapped);
+		m_size = static_cast<size_t>(info.st_size);
+	}
+#endif
+	if (m_data == NULL)
+	{
+		close();
+		return false;
+	}
+
+	  // Check the header and the whole index now, so that loadLevel can
+	  // trust them
+	if (!equal(m_data, m_data + sizeof(PACK_MAGIC), PACK_MAGIC)  ||  getBytes(m_data + 4, 4) != PACK_VERSION)
+	{
+		close();
+		return false;
+	}
+	uint64_t numLevels = getBytes(m_data + 8, 4);
+	if (HEADER_SIZE + numLevels * INDEX_ENTRY_SIZE > m_size)
+	{
+		close();
+		return false;
+	}
+	for (uint64_t k = 0; k < numLevels; k++)
+	{
+		const char* entry = m_data + HEADER_SIZE + k * INDEX_ENTRY_SIZE;
+		uint64_t offset = getBytes(entry, 8);
+		uint64_t size = getBytes(entry + 8, 4);
+		if (offset > m_size  ||  size > m_size - offset)
+		{
+			close();
+			return false;
+		}
+	}
+	m_numLevels = static_cast<size_t>(numLevels);
+	return true;
+}
+
+void LevelPack::close()
+{
+#ifdef _WIN32
+	if (m_data != NULL)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != NULL)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_mapping = NULL;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data != NULL)
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+	m_data = NULL;
+	m_size = 0;
+	m_numLevels = 0;
+}
+
+Level::LoadResult LevelPack::loadLevel(Level& level, unsigned int levelNumber) const
+{
+	if (levelNumber >= m_numLevels)
+		return Level::load_fail_file_not_found;
+	const char* entry = m_data + HEADER_SIZE + size_t(levelNumber) * INDEX_ENTRY_SIZE;
+	return CompiledLevel::load(level, m_data + getBytes(entry, 8),
+							   static_cast<size_t>(getBytes(entry + 8, 4)));
+}
+
+uint32_t LevelPack::getChecksum() const
+{
+	uint32_t hash = 2166136261u;
+	for (size_t k = 0; k <= m_numLevels; k++)
+	{
+		uint64_t value = m_numLevels;
+		if (k < m_numLevels)
+		{
+			const char* entry = m_data + HEADER_SIZE + k * INDEX_ENTRY_SIZE;
+			uint64_t offset = getBytes(entry, 8);
+			uint64_t size = getBytes(entry + 8, 4);
+			value = size >= 4 ? getBytes(m_data + offset + size - 4, 4) : 0;
+		}
+		for (int b = 0; b < 4; b++)
+		{
+			hash ^= (value >> (8*b)) & 0xff;
+			hash *= 16777619u;
+		}
+	}
+	return hash != 0 ? hash : 1;
+}
+
+void LevelPack::build(const vector<vector<char> >& levels, vector<char>& out)
+{
+	out.assign(PACK_MAGIC, PACK_MAGIC + sizeof(PACK_MAGIC));
+	putBytes(out, PACK_VERSION, 4);
+	putBytes(out, levels.size(), 4);
+	putBytes(out, 0, 4);
+
+	uint64_t offset = HEADER_SIZE + levels.size() * INDEX_ENTRY_SIZE;
+	for (size_t k = 0; k < levels.size(); k++)
+	{
+		putBytes(out, offset, 8);
+		putBytes(out, levels[k].size(), 4);
+		putBytes(out, 0, 4);
+		offset += levels[k].size();
+	}
+	for (size_t k = 0; k < levels.size(); k++)
+		out.insert(out.end(), levels[k].begin(), levels[k].end());
+}
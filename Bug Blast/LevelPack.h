@@ -0,0 +1,67 @@
+#ifndef LEVELPACK_H_
+#define LEVELPACK_H_
+
+#include "Level.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+  // Many compiled levels in one file, mapped into memory once and read in
+  // place by level number:
+  //
+  //   "BBLP", version, level count, 0        4 bytes each
+  //   index                                  per level: 8-byte offset from
+  //                                          the start of the file, 4-byte
+  //                                          size, 4 bytes of 0
+  //   levels                                 each in CompiledLevel's format
+  //
+  // All numbers are little-endian.  A pack only reads the mapping once it
+  // is open, so any number of worlds on any number of threads can share
+  // one.
+
+class LevelPack
+{
+  public:
+	static const char* const FILE_EXTENSION;  // ".bbp"
+
+	LevelPack();
+	~LevelPack();
+
+	  // False if the file is missing, not a pack, or its index points
+	  // outside it.
+	bool open(std::string filename);
+	void close();
+
+	size_t getNumLevels() const
+	{
+		return m_numLevels;
+	}
+
+	  // Tells packs apart, e.g. so a replay can say which one it was
+	  // recorded against: a hash of the level count and every level's own
+	  // checksum.  Never 0, which stands for the levelNN files.
+	uint32_t getChecksum() const;
+
+	  // load_fail_file_not_found past the last level, as for a missing
+	  // levelNN.dat
+	Level::LoadResult loadLevel(Level& level, unsigned int levelNumber) const;
+
+	  // Replaces out with a pack holding these compiled levels, in order.
+	static void build(const std::vector<std::vector<char> >& levels, std::vector<char>& out);
+
+  private:
+	  // Prevent copying: the mapping belongs to exactly one pack
+	LevelPack(const LevelPack&);
+	LevelPack& operator=(const LevelPack&);
+
+	const char* m_data;
+	size_t		m_size;
+	size_t		m_numLevels;
+#ifdef _WIN32
+	void*		m_file;
+	void*		m_mapping;
+#endif
+};
+
+#endif // LEVELPACK_H_
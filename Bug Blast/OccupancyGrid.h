@@ -0,0 +1,102 @@
+#ifndef OCCUPANCYGRID_H_
+#define OCCUPANCYGRID_H_
+
+#include "GameConstants.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+class Actor;
+
+//=================================================
+//An index from board cell to the actors standing in it, so that "what is at
+//(x, y)" costs the handful of actors in that cell instead of a walk over
+//every actor in the world. StudentWorld keeps it up to date as actors are
+//added, move and are removed.
+//The cells are kept in BOARD_CHUNK_SIZE square chunks. A chunk only exists
+//while some actor stands in it, so a big board that is mostly empty costs
+//a pointer per empty chunk.
+class OccupancyGrid{
+public:
+	OccupancyGrid(int width = VIEW_WIDTH, int height = VIEW_HEIGHT) : m_width(width), m_height(height){
+		m_chunksWide = (width + BOARD_CHUNK_SIZE - 1) >> BOARD_CHUNK_SHIFT;
+		m_chunks.resize(m_chunksWide * ((height + BOARD_CHUNK_SIZE - 1) >> BOARD_CHUNK_SHIFT));
+	}
+
+	void add(Actor* actor, int x, int y){
+		if (!inBounds(x, y))
+			return;
+		std::unique_ptr<Chunk>& chunk = m_chunks[chunkIndex(x, y)];
+		if (!chunk){
+			//The last chunk to empty out is the likeliest to be wanted back
+			if (m_spare)
+				chunk.swap(m_spare);
+			else
+				chunk.reset(new Chunk);
+		}
+		chunk->cells[cellInChunk(x, y)].push_back(actor);
+		chunk->numActors++;
+	}
+
+	void remove(Actor* actor, int x, int y){
+		if (!inBounds(x, y))
+			return;
+		std::unique_ptr<Chunk>& chunk = m_chunks[chunkIndex(x, y)];
+		if (!chunk)
+			return;
+		std::vector<Actor*>& cell = chunk->cells[cellInChunk(x, y)];
+		std::vector<Actor*>::iterator it = std::find(cell.begin(), cell.end(), actor);
+		if (it == cell.end())
+			return;
+		cell.erase(it);
+		if (--chunk->numActors == 0){
+			m_spare.swap(chunk);
+			chunk.reset();
+		}
+	}
+
+	void move(Actor* actor, int fromX, int fromY, int toX, int toY){
+		remove(actor, fromX, fromY);
+		add(actor, toX, toY);
+	}
+
+	//Off the board is simply empty
+	const std::vector<Actor*>& at(int x, int y) const{
+		static const std::vector<Actor*> nothing;
+		if (!inBounds(x, y))
+			return nothing;
+		const std::unique_ptr<Chunk>& chunk = m_chunks[chunkIndex(x, y)];
+		return chunk ? chunk->cells[cellInChunk(x, y)] : nothing;
+	}
+
+	void clear(){
+		for (size_t i = 0; i < m_chunks.size(); i++)
+			m_chunks[i].reset();
+	}
+
+private:
+	struct Chunk{
+		Chunk() : numActors(0){
+		}
+		std::vector<Actor*> cells[BOARD_CHUNK_SIZE * BOARD_CHUNK_SIZE];
+		int numActors;
+	};
+
+	bool inBounds(int x, int y) const{
+		return x >= 0 && x < m_width && y >= 0 && y < m_height;
+	}
+	int chunkIndex(int x, int y) const{
+		return (y >> BOARD_CHUNK_SHIFT) * m_chunksWide + (x >> BOARD_CHUNK_SHIFT);
+	}
+	static int cellInChunk(int x, int y){
+		return ((y & (BOARD_CHUNK_SIZE - 1)) << BOARD_CHUNK_SHIFT) | (x & (BOARD_CHUNK_SIZE - 1));
+	}
+
+	int m_width;
+	int m_height;
+	int m_chunksWide;
+	std::vector<std::unique_ptr<Chunk> > m_chunks;		//empty chunks are null
+	std::unique_ptr<Chunk> m_spare;
+};
+
+#endif // OCCUPANCYGRID_H_
@@ -0,0 +1,85 @@
+#ifndef RANDOMGENERATOR_H_
+#define RANDOMGENERATOR_H_
+
+#include <cstdint>
+
+//=================================================
+//A small, fast PRNG (xoshiro256**) so that every world owns its randomness.
+//The same seed always gives the same game, and worlds on different threads
+//never touch each other's state.
+class RandomGenerator{
+public:
+	RandomGenerator(uint64_t seed = 0){
+		setSeed(seed);
+	}
+
+	//Expand a single seed into the full state with splitmix64, so that
+	//nearby seeds (1, 2, 3...) still give unrelated streams
+	void setSeed(uint64_t seed){
+		for (int i = 0; i < 4; i++){
+			seed += 0x9e3779b97f4a7c15ULL;
+			uint64_t z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			m_state[i] = z ^ (z >> 31);
+		}
+	}
+
+	uint64_t next(){
+		uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+		uint64_t t = m_state[1] << 17;
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = rotl(m_state[3], 45);
+		return result;
+	}
+
+	//Returns a number in [0, n); like rand() % n but without the global state
+	int nextInt(int n){
+		if (n <= 0)
+			return 0;
+		return (int)(next() % (uint64_t)n);
+	}
+
+	//Advance 2^128 steps. Each jump starts a stream that won't overlap
+	//the previous one for any realistic run length.
+	void jump(){
+		static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+		uint64_t s[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < 4; i++){
+			for (int b = 0; b < 64; b++){
+				if (JUMP[i] & (1ULL << b))
+					for (int k = 0; k < 4; k++)
+						s[k] ^= m_state[k];
+				next();
+			}
+		}
+		for (int k = 0; k < 4; k++)
+			m_state[k] = s[k];
+	}
+
+	//The raw state, for hashing a world's state
+	const uint64_t* getState() const{
+		return m_state;
+	}
+
+	//Hand out the current stream and jump this generator past it, so
+	//split() can be called repeatedly to give each consumer its own stream
+	RandomGenerator split(){
+		RandomGenerator child(*this);
+		jump();
+		return child;
+	}
+
+private:
+	static uint64_t rotl(uint64_t x, int k){
+		return (x << k) | (x >> (64 - k));
+	}
+
+	uint64_t m_state[4];
+};
+
+#endif // RANDOMGENERATOR_H_
@@ -0,0 +1,122 @@
+#include "Replay.h"
+#include "GameConstants.h"
+#include <algorithm>
+using namespace std;
+
+static const char	  REPLAY_MAGIC[4] = { 'B', 'B', 'R', 'P' };
+static const uint32_t REPLAY_VERSION = 2;  // 1 had no level pack checksum
+
+  // One-byte codes for the keys a world actually reads; anything else is
+  // written as KEY_ESCAPE followed by the full 32-bit key.
+static const int KEY_CODES[] = {
+	INVALID_KEY, KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_DOWN, KEY_PRESS_SPACE
+};
+static const int NUM_KEY_CODES = sizeof(KEY_CODES)/sizeof(KEY_CODES[0]);
+static const unsigned char KEY_ESCAPE = 0xff;
+
+static void writeBytes(ofstream& out, uint64_t value, int numBytes)
+{
+	for (int k = 0; k < numBytes; k++)
+		out.put(static_cast<char>((value >> (8*k)) & 0xff));
+}
+
+static bool readBytes(ifstream& in, uint64_t& value, int numBytes)
+{
+	value = 0;
+	for (int k = 0; k < numBytes; k++)
+	{
+		int c = in.get();
+		if (c == EOF)
+			return false;
+		value |= uint64_t(c) << (8*k);
+	}
+	return true;
+}
+
+bool ReplayRecorder::open(string filename, uint64_t seed, unsigned int startLevel, uint32_t levelPack)
+{
+	m_file.open(filename.c_str(), ios::binary);
+	if (!m_file)
+		return false;
+	m_file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+	writeBytes(m_file, REPLAY_VERSION, 4);
+	writeBytes(m_file, seed, 8);
+	writeBytes(m_file, startLevel, 4);
+	writeBytes(m_file, levelPack, 4);
+	m_key = INVALID_KEY;
+	m_ticks = 0;
+	return true;
+}
+
+void ReplayRecorder::tickEnded(uint64_t stateHash)
+{
+	if (!m_file.is_open())
+		return;
+
+	int code = 0;
+	while (code < NUM_KEY_CODES  &&  KEY_CODES[code] != m_key)
+		code++;
+	if (code < NUM_KEY_CODES)
+		m_file.put(static_cast<char>(code));
+	else
+	{
+		m_file.put(static_cast<char>(KEY_ESCAPE));
+		writeBytes(m_file, static_cast<uint32_t>(m_key), 4);
+	}
+	writeBytes(m_file, stateHash & 0xffffffff, 4);
+
+	m_key = INVALID_KEY;
+	m_ticks++;
+}
+
+bool Replay::load(string filename)
+{
+	ifstream in(filename.c_str(), ios::binary);
+	if (!in)
+		return false;
+
+	char magic[sizeof(REPLAY_MAGIC)];
+	uint64_t version, level, pack = 0;
+	if (!in.read(magic, sizeof(magic))  ||  !equal(magic, magic + sizeof(magic), REPLAY_MAGIC))
+		return false;
+	if (!readBytes(in, version, 4)  ||  version < 1  ||  version > REPLAY_VERSION)
+		return false;
+	if (!readBytes(in, seed, 8)  ||  !readBytes(in, level, 4))
+		return false;
+	if (version >= 2  &&  !readBytes(in, pack, 4))
+		return false;
+	startLevel = static_cast<unsigned int>(level);
+	levelPack = static_cast<uint32_t>(pack);
+
+	keys.clear();
+	hashes.clear();
+	for (int code; (code = in.get()) != EOF; )
+	{
+		uint64_t key, hash;
+		if (code < NUM_KEY_CODES)
+			key = KEY_CODES[code];
+		else if (code != KEY_ESCAPE  ||  !readBytes(in, key, 4))
+			return false;
+		if (!readBytes(in, hash, 4))
+			return false;  // truncated record
+		keys.push_back(static_cast<int>(key));
+		hashes.push_back(static_cast<uint32_t>(hash));
+	}
+	return true;
+}
+
+bool ReplayPlayer::nextKey(int& value)
+{
+	if (m_nextKey >= m_replay.keys.size())
+		return false;
+	value = m_replay.keys[m_nextKey++];
+	return value != INVALID_KEY;
+}
+
+void ReplayPlayer::tickEnded(uint64_t stateHash)
+{
+	if (m_firstMismatch < 0  &&
+		(m_ticks >= m_replay.hashes.size()  ||  m_replay.hashes[m_ticks] != uint32_t(stateHash)))
+		m_firstMismatch = static_cast<long>(m_ticks);
+	m_ticks++;
+}
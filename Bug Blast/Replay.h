@@ -0,0 +1,94 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "GameWorld.h"
+#include "HeadlessDriver.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+  // A replay file is a small header (magic, version, seed, start level,
+  // level pack checksum) followed by one record per tick: the key the
+  // world read during that tick (one byte for the usual keys) and the low
+  // 32 bits of the world's state hash after it.  Records are appended as
+  // the game runs, so a session that ends abruptly still leaves a usable
+  // file.
+
+class ReplayRecorder : public TickObserver
+{
+  public:
+	ReplayRecorder()
+	 : m_key(INVALID_KEY), m_ticks(0)
+	{
+	}
+
+	  // The caller must also give the world this seed and start level, and
+	  // the pack whose LevelPack::getChecksum() is levelPack (0 if the
+	  // world reads the levelNN files).
+	bool open(std::string filename, uint64_t seed, unsigned int startLevel, uint32_t levelPack = 0);
+
+	virtual void keyRead(int key)
+	{
+		m_key = key;
+	}
+
+	virtual void tickEnded(uint64_t stateHash);
+
+	unsigned long getTicks() const
+	{
+		return m_ticks;
+	}
+
+  private:
+	std::ofstream m_file;
+	int			  m_key;
+	unsigned long m_ticks;
+};
+
+struct Replay
+{
+	uint64_t			  seed;
+	unsigned int		  startLevel;
+	uint32_t			  levelPack;	// LevelPack::getChecksum(), or 0 for levelNN files
+	std::vector<int>	  keys;		// per tick; INVALID_KEY for none
+	std::vector<uint32_t> hashes;	// per tick
+
+	bool load(std::string filename);
+};
+
+  // Feeds a Replay's keys back to a world and checks the world's state
+  // hash after every tick.  Attach it as both the KeySource of a
+  // HeadlessDriver and the TickObserver of the world, and run the driver
+  // for exactly keys.size() ticks.
+
+class ReplayPlayer : public KeySource, public TickObserver
+{
+  public:
+	ReplayPlayer(const Replay& replay)
+	 : m_replay(replay), m_nextKey(0), m_ticks(0), m_firstMismatch(-1)
+	{
+	}
+
+	virtual bool nextKey(int& value);
+
+	virtual void keyRead(int /* key */)
+	{
+	}
+
+	virtual void tickEnded(uint64_t stateHash);
+
+	  // -1 if every tick so far matched the recording
+	long getFirstMismatch() const
+	{
+		return m_firstMismatch;
+	}
+
+  private:
+	const Replay& m_replay;
+	size_t		  m_nextKey;
+	size_t		  m_ticks;
+	long		  m_firstMismatch;
+};
+
+#endif // REPLAY_H_
@@ -2,10 +2,13 @@
 #include "Actor.h"
 #include "GameConstants.h"
 #include <iomanip>
-#include "level.h"
-#include <list>
+#include "Level.h"
+#include "CompiledLevel.h"
+#include "LevelPack.h"
+#include <vector>
 #include <sstream>
 #include <string>
+#include <ctime>
 
 using namespace std;
 
@@ -14,19 +17,45 @@ GameWorld* createStudentWorld()
 	return new StudentWorld();
 }
 
+//Used by getStateHash
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t fnvMix(uint64_t hash, uint64_t value){
+	for (int i = 0; i < 8; i++){
+		hash ^= (value >> (8 * i)) & 0xff;
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+//Used by getViewOrigin
+static double clampViewOrigin(double origin, int maxOrigin){
+	if (origin > maxOrigin)
+		origin = maxOrigin;
+	return origin < 0 ? 0 : origin;
+}
+
+//The actors each BoardLayer tracks
+static const unsigned int LAYER_KINDS[NUM_BOARD_LAYERS] = {
+	KIND_PERMA_BRICK, KIND_DESTROYABLE_BRICK, KIND_BUGSPRAYER, KIND_ZUMI, KIND_BUGSPRAY
+};
+
 //==========================================
 //Public Functions
 
 //Inherited
+StudentWorld::StudentWorld() : m_boardWidth(VIEW_WIDTH), m_boardHeight(VIEW_HEIGHT), m_numDeadBricks(0), m_numZumis(0), m_sprayPool(m_arena), m_sprayerPool(m_arena), m_extraLifePool(m_arena),
+	m_walkThruPool(m_arena), m_extraSprayerPool(m_arena), m_sprayRadiusPool(m_arena), m_player(nullptr), m_level(nullptr), m_levelPack(nullptr), m_lastCauseOfDeath(CAUSE_NONE), m_random((uint64_t)time(0)),
+	m_prefetch(nullptr), m_prefetchResult(GWSTATUS_CONTINUE_GAME){
+	//Seeded from the clock unless the caller calls setSeed for a reproducible game
+}
+
 StudentWorld::~StudentWorld(){
-	//The same as cleanUp()
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end(); it++){
-		delete *it;
-	}
-	m_actorList.clear();
+	discardPrefetch();
 
-	delete m_player;
-	m_player = nullptr;
+	//The same as cleanUp()
+	deleteAllActors();
 
 	delete m_level;
 	m_level = nullptr;
@@ -34,80 +63,43 @@ StudentWorld::~StudentWorld(){
 
 int StudentWorld::init()
 {
-	srand((unsigned int)time(0));
+	//The level may already have been built in the background
+	if (m_prefetch != nullptr && m_prefetch->getLevel() == getLevel() &&
+		(m_prefetch->getGraphObjects() != nullptr) == (getGraphObjects() != nullptr))
+		return adoptPrefetch();
+	discardPrefetch();
+
 	m_level = new Level;
 	m_numSprayers = 0;
 	m_levelCompleted = false;
 	m_exitRevealed = false;
+	m_playerDistances.reset();
+	m_blast.reset();
+	for (int i = 0; i < NUM_BOARD_LAYERS; i++)
+		m_layers[i].clear();
 	return setMap(getLevel());
 }
 
 int StudentWorld::move()
 {
-	// Update the Game Status Line 
-	setDisplayText(); 
-
-	//Let the player move first
-	if (m_player->isAlive())
-		m_player->doSomething();
-
-	//Then the other actors
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end(); it++){
-		//Let each actor act
-		if ((*it)->isAlive())
-			(*it)->doSomething();
-		//If the player is dead, return the message
-		if (!m_player->isAlive()){
-			decLives();
-			return GWSTATUS_PLAYER_DIED;
-		}
-		//If the player has completed the level, act accordingly
-		if (m_levelCompleted){
-			increaseScore(m_bonus);
-			return GWSTATUS_FINISHED_LEVEL;
-		}
-	}
-	
-	removeDead();
-
-	if (m_bonus>0)
-		m_bonus--;
-	
-	//Check if all bugs are dead
-	bool allZumiDead = true;
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end(); it++){
-		//Looking for any living bug
-		if (dynamic_cast<Zumi*>(*it) && (*it)->isAlive()){
-			allZumiDead = false;
-			break;
-		}
-	}
-	if (allZumiDead && !m_exitRevealed)
-		exposeExit();
+	int result = doMove();
 
-	if (!m_player->isAlive()){
-		decLives();
-		return GWSTATUS_PLAYER_DIED;
-	}
+	//Let whoever is recording or verifying this game see the outcome of the tick
+	if (getTickObserver() != nullptr)
+		getTickObserver()->tickEnded(getStateHash());
 
-	//If the player has won, act accordingly
-	if (m_levelCompleted){
-		increaseScore(m_bonus);
-		return GWSTATUS_FINISHED_LEVEL;
-	}
+	//Nothing happens between here and the next init but cleanUp, so if the
+	//host is going to wait on the player first, use the time to build the
+	//next level
+	if (result == GWSTATUS_FINISHED_LEVEL && pausesBetweenLevels())
+		prefetchLevel(getLevel() + 1);
 
-	return GWSTATUS_CONTINUE_GAME;
+	return result;
 }
 
 void StudentWorld::cleanUp()
 {
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end(); it++){
-		delete *it;
-	}
-	m_actorList.clear();
-
-	delete m_player;
-	m_player = nullptr;
+	deleteAllActors();
 
 	delete m_level;
 	m_level = nullptr;
@@ -115,7 +107,68 @@ void StudentWorld::cleanUp()
 
 //Mutator
 void StudentWorld::addActor(Actor* actor){
-	m_actorList.push_front(actor);
+	if (actor->isKind(KIND_BRICK))
+		m_bricks.push_back(actor);
+	else
+		m_actors.push_back(actor);
+	if (actor->isKind(KIND_ZUMI))
+		m_numZumis++;
+	m_grid.add(actor, actor->getX(), actor->getY());
+	updateLayers(actor->getX(), actor->getY(), actor->getKind());
+	if (actor->isKind(KIND_BRICK | KIND_BUGSPRAYER))
+		m_playerDistances.setBlocked(actor->getX(), actor->getY(), true);
+	if (actor->isKind(KIND_PERMA_BRICK))
+		m_blast.setWall(actor->getX(), actor->getY());
+	else if (actor->isKind(KIND_DESTROYABLE_BRICK))
+		m_blast.setBrick(actor->getX(), actor->getY(), true);
+}
+
+void StudentWorld::moveActor(Actor* actor, int x, int y){
+	m_grid.move(actor, actor->getX(), actor->getY(), x, y);
+	updateLayers(actor->getX(), actor->getY(), actor->getKind());
+	updateLayers(x, y, actor->getKind());
+}
+
+//Set off a sprayer, and in the same tick every sprayer caught in its spray,
+//every sprayer caught in theirs, and so on. Each cell covered by the chain
+//gets a single spray however many blasts reach it.
+void StudentWorld::detonate(BugSprayer* sprayer){
+	playSound(SOUND_SPRAY);
+
+	vector<BugSprayer*> chain(1, sprayer);
+	sprayer->explode();
+	Bitboard covered = m_layers[LAYER_WALLS];
+	covered.clear();
+	vector<BlastCell> sprayCells;
+	for (size_t k = 0; k < chain.size(); k++){
+		const vector<BlastCell>& cells = getBlastCells(chain[k]->getX(), chain[k]->getY(), chain[k]->getRadius());
+		for (size_t i = 0; i < cells.size(); i++){
+			if (covered.test(cells[i].x, cells[i].y))
+				continue;
+			covered.set(cells[i].x, cells[i].y);
+			sprayCells.push_back(cells[i]);
+
+			const vector<Actor*>& actors = m_grid.at(cells[i].x, cells[i].y);
+			for (size_t j = 0; j < actors.size(); j++){
+				if (actors[j]->isKind(KIND_BUGSPRAYER) && actors[j]->isAlive()){
+					BugSprayer* next = static_cast<BugSprayer*>(actors[j]);
+					next->explode();
+					chain.push_back(next);
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < sprayCells.size(); i++)
+		addPooled<BugSpray>(sprayCells[i].x, sprayCells[i].y, this);
+}
+
+//A spray marks its cell on its turn; applySprayDamage hurts what is there
+void StudentWorld::addSprayDamage(int x, int y){
+	if (m_sprayDamage.test(x, y))
+		return;
+	m_sprayDamage.set(x, y);
+	m_sprayCells.push_back(y * m_boardWidth + x);
 }
 
 void StudentWorld::completeLevel(){
@@ -130,29 +183,224 @@ void StudentWorld::decNumSprayers(){
 	m_numSprayers--;
 }
 
+//A level built ahead of time drew from the old generator (or read the old
+//pack), so these throw it away
+void StudentWorld::setSeed(uint64_t seed){
+	discardPrefetch();
+	m_random.setSeed(seed);
+}
+
+void StudentWorld::setRandomGenerator(const RandomGenerator& generator){
+	discardPrefetch();
+	m_random = generator;
+}
+
+//The pack is only read, so many worlds can share one; it must stay open
+//for as long as this world plays
+void StudentWorld::setLevelPack(const LevelPack* pack){
+	discardPrefetch();
+	m_levelPack = pack;
+}
+
 //Accessor
 int StudentWorld::getNumSprayers() const{
 	return m_numSprayers;
 }
 
-list<Actor*>& StudentWorld::getActors(){
-	return m_actorList;
+int StudentWorld::getLastCauseOfDeath() const{
+	return m_lastCauseOfDeath;
+}
+
+int StudentWorld::getRand(int n){
+	return m_random.nextInt(n);
+}
+
+GoodieDrop StudentWorld::rollGoodieDrop(){
+	return m_level->rollGoodieDrop(m_random);
+}
+
+//Steps from (x, y) to the player counting (x, y) itself, or INT_MAX if there is
+//no path short enough to be worth following. addActor and removeDead keep
+//the field's obstacles up to date as bricks and sprayers come and go; it
+//only searches from scratch when the player has moved since some
+//ComplexZumi last asked.
+int StudentWorld::getDistToPlayer(int x, int y){
+	m_playerDistances.setTarget(m_player->getX(), m_player->getY());
+
+	int dist = m_playerDistances.distanceFrom(x, y);
+	return dist == DistanceField::UNREACHABLE ? INT_MAX : dist + 1;
+}
+
+//The cells a spray from (x, y) reaching radius cells each way lands on, in
+//the order the sprays should be added. The list is overwritten by the next call.
+const vector<BlastCell>& StudentWorld::getBlastCells(int x, int y, int radius){
+	m_blast.getBlastCells(x, y, radius, m_blastCells);
+	return m_blastCells;
+}
+
+//FNV-1a over everything that decides how the game plays out from here.
+//Two runs with the same hash after every tick took the same path.
+uint64_t StudentWorld::getStateHash() const{
+	uint64_t hash = FNV_OFFSET;
+	hash = fnvMix(hash, getLevel());
+	hash = fnvMix(hash, getLives());
+	hash = fnvMix(hash, getScore());
+	hash = fnvMix(hash, m_bonus);
+	hash = fnvMix(hash, m_numSprayers);
+	hash = fnvMix(hash, m_exitRevealed);
+	for (int i = 0; i < 4; i++)
+		hash = fnvMix(hash, m_random.getState()[i]);
+
+	if (m_player != nullptr){
+		hash = fnvMix(hash, m_player->getX());
+		hash = fnvMix(hash, m_player->getY());
+		hash = fnvMix(hash, m_player->isAlive());
+	}
+
+	//Summing the actors' hashes keeps this independent of how they are stored
+	uint64_t actorsHash = 0;
+	for (size_t i = 0; i < m_actors.size() + m_bricks.size(); i++){
+		const Actor* actor = i < m_actors.size() ? m_actors[i] : m_bricks[i - m_actors.size()];
+		uint64_t actorHash = FNV_OFFSET;
+		actorHash = fnvMix(actorHash, actor->getID());
+		actorHash = fnvMix(actorHash, actor->getX());
+		actorHash = fnvMix(actorHash, actor->getY());
+		actorHash = fnvMix(actorHash, actor->isAlive());
+		actorsHash += actorHash;
+	}
+	return fnvMix(hash, actorsHash);
+}
+
+//Everything that acts, besides the player; bricks are found by getActorsAt
+const vector<Actor*>& StudentWorld::getActors() const{
+	return m_actors;
+}
+
+bool StudentWorld::containsKind(int x, int y, unsigned int kindMask) const{
+	const vector<Actor*>& cell = m_grid.at(x, y);
+	for (size_t i = 0; i < cell.size(); i++){
+		if (cell[i]->isKind(kindMask))
+			return true;
+	}
+	return false;
+}
+
+const vector<Actor*>& StudentWorld::getActorsAt(int x, int y) const{
+	return m_grid.at(x, y);
+}
+
+const Bitboard& StudentWorld::getLayer(BoardLayer layer) const{
+	return m_layers[layer];
 }
 
 Player* StudentWorld::getPlayer() const{
 	return m_player;
 }
 
+const DistanceField& StudentWorld::getPlayerDistances() const{
+	return m_playerDistances;
+}
+
 Level* StudentWorld::getCurrentLevel() const{
 	return m_level;
 }
 
+int StudentWorld::getBoardWidth() const{
+	return m_boardWidth;
+}
+
+int StudentWorld::getBoardHeight() const{
+	return m_boardHeight;
+}
+
+//Keeps the player in the middle of the screen until an edge of the board
+//comes into view. A board no bigger than the screen never moves.
+void StudentWorld::getViewOrigin(double& x, double& y) const{
+	x = 0;
+	y = 0;
+	if (m_player == nullptr)
+		return;
+	double playerX, playerY;
+	m_player->getAnimationLocation(playerX, playerY);
+	x = clampViewOrigin(playerX - VIEW_WIDTH / 2, m_boardWidth - VIEW_WIDTH);
+	y = clampViewOrigin(playerY - VIEW_HEIGHT / 2, m_boardHeight - VIEW_HEIGHT);
+}
+
 //==========================================
 //Private Functions
 
+int StudentWorld::doMove(){
+	// Update the Game Status Line 
+	setDisplayText(); 
+
+	//Let the player move first
+	if (m_player->isAlive())
+		m_player->doSomething();
+
+	//Then the other actors, newest first. Anything added along the way goes on
+	//the end and waits for the next tick.
+	for (size_t i = m_actors.size(); i-- > 0; ){
+		//Let each actor act
+		if (m_actors[i]->isAlive())
+			m_actors[i]->doSomething();
+		//Sprays only mark their cells, and a sprayer adds its sprays all
+		//together, so the cells a run of them marked are hurt once the last of
+		//the run has acted (or straight away if the tick is about to end)
+		bool runGoesOn = i > 0 && m_actors[i]->isKind(KIND_BUGSPRAY) && m_actors[i - 1]->isKind(KIND_BUGSPRAY);
+		if (!runGoesOn || !m_player->isAlive() || m_levelCompleted)
+			applySprayDamage();
+		//If the player is dead, return the message
+		if (!m_player->isAlive()){
+			m_lastCauseOfDeath = m_player->getCauseOfDeath();
+			decLives();
+			return GWSTATUS_PLAYER_DIED;
+		}
+		//If the player has completed the level, act accordingly
+		if (m_levelCompleted){
+			increaseScore(m_bonus);
+			return GWSTATUS_FINISHED_LEVEL;
+		}
+	}
+	
+	removeDead();
+
+	if (m_bonus>0)
+		m_bonus--;
+	
+	//Check if all bugs are dead; removeDead has just taken away the dead ones
+	bool allZumiDead = m_numZumis == 0;
+	if (allZumiDead && !m_exitRevealed)
+		exposeExit();
+
+	if (!m_player->isAlive()){
+		m_lastCauseOfDeath = m_player->getCauseOfDeath();
+		decLives();
+		return GWSTATUS_PLAYER_DIED;
+	}
+
+	//If the player has won, act accordingly
+	if (m_levelCompleted){
+		increaseScore(m_bonus);
+		return GWSTATUS_FINISHED_LEVEL;
+	}
+
+	return GWSTATUS_CONTINUE_GAME;
+}
+
 int StudentWorld::setMap(int levelNumber){
-	string currentLevelName = toStrFileName(levelNumber);
-	Level::LoadResult result = m_level->loadLevel(currentLevelName);
+	//Levels come from the pack if there is one. Otherwise a level compiled by
+	//levelc is taken over the text, which it skips parsing, unless the text
+	//has changed since it was compiled.
+	Level::LoadResult result;
+	if (m_levelPack != nullptr)
+		result = m_levelPack->loadLevel(*m_level, levelNumber);
+	else{
+		string currentLevelName = toStrFileName(levelNumber);
+		result = CompiledLevel::load(*m_level, CompiledLevel::compiledName(currentLevelName),
+			currentLevelName);
+		if (result == Level::load_fail_file_not_found)
+			result = m_level->loadLevel(currentLevelName);
+	}
 
 	if (result == Level::load_fail_bad_format)
 		return GWSTATUS_LEVEL_ERROR;
@@ -161,35 +409,44 @@ int StudentWorld::setMap(int levelNumber){
 	else if (result == Level::load_fail_file_not_found)
 		return GWSTATUS_PLAYER_WON;
 
+	setBoardSize(m_level->getWidth(), m_level->getHeight());
+
+	//A ComplexZumi only smells the player from within complexZumiSearchDistance
+	//along each axis, which across open ground is at most twice that many
+	//steps. A longer path is a detour it has no business knowing about, so the
+	//search stops there (less one, since getDistToPlayer adds the first step).
+	m_playerDistances.setDepthLimit(2 * m_level->getOption(OPTION_COMPLEX_ZUMI_SEARCH_DISTANCE) - 1);
+
 	//Add actors into the world
-	for (int i = 0; i < VIEW_WIDTH; i++){
-		for (int j = 0; j < VIEW_WIDTH; j++){
+	for (int i = 0; i < m_boardWidth; i++){
+		for (int j = 0; j < m_boardHeight; j++){
 			Level::MazeEntry entry = m_level->getContentsOf(i, j);
 			switch(entry){
 			case (Level::player):
-				m_player = new Player(i, j, this);
+				m_player = m_arena.create<Player>(i, j, this);
+				m_grid.add(m_player, i, j);
 				break;
 			case (Level::perma_brick):
-				addActor(new PermaBrick(i, j, this));
+				addActor(m_arena.create<PermaBrick>(i, j, this));
 				break;
 			case (Level::destroyable_brick):
-				addActor(new DestroyableBrick(i, j, this));
+				addActor(m_arena.create<DestroyableBrick>(i, j, this));
 				break;
 			case (Level::exit) :
-				addActor(new Exit(i, j, this));
+				addActor(m_arena.create<Exit>(i, j, this));
 				break;
 			case (Level::simple_zumi):
-				addActor(new SimpleZumi(i, j, this));
+				addActor(m_arena.create<SimpleZumi>(i, j, this));
 				break;
 			case (Level::complex_zumi) :
-				addActor(new ComplexZumi(i, j, this));
+				addActor(m_arena.create<ComplexZumi>(i, j, this));
 				break;
 			}
 		}
 	}
 
 	//Get values
-	m_bonus = m_level->getOptionValue(optionLevelBonus);
+	m_bonus = m_level->getOption(OPTION_LEVEL_BONUS);
 
 	return GWSTATUS_CONTINUE_GAME;
 }
@@ -203,23 +460,215 @@ string StudentWorld::toStrFileName(int levelNumber){
 	return result;
 }
 
+//Only spray kills bricks, and applySprayDamage counts them, so on a big
+//board the ticks where no brick died skip the walk over all the bricks
 void StudentWorld::removeDead(){
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end();){
-		if (!(*it)->isAlive()){
-			list<Actor*>::iterator toDelete = it;
-			it++;
-			delete *(toDelete);
-			m_actorList.erase(toDelete);
+	removeDeadFrom(m_actors);
+	if (m_numDeadBricks > 0)
+		removeDeadFrom(m_bricks);
+	m_numDeadBricks = 0;
+}
+
+//Slides the survivors down over the dead in one pass, so the actors keep
+//their order (and so the order they act in). Swapping the last actor into a
+//dead one's place would be cheaper, but would change who acts first.
+void StudentWorld::removeDeadFrom(vector<Actor*>& actors){
+	size_t numAlive = 0;
+	for (size_t i = 0; i < actors.size(); i++){
+		Actor* actor = actors[i];
+		if (actor->isAlive()){
+			actors[numAlive++] = actor;
+			continue;
 		}
-		else
-			it++;
+		int x = actor->getX(), y = actor->getY();
+		m_grid.remove(actor, x, y);
+		updateLayers(x, y, actor->getKind());
+		if (actor->isKind(KIND_BRICK | KIND_BUGSPRAYER) && !containsKind(x, y, KIND_BRICK | KIND_BUGSPRAYER))
+			m_playerDistances.setBlocked(x, y, false);
+		if (actor->isKind(KIND_DESTROYABLE_BRICK))
+			m_blast.setBrick(x, y, containsKind(x, y, KIND_DESTROYABLE_BRICK));
+		if (actor->isKind(KIND_ZUMI))
+			m_numZumis--;
+		deleteActor(actor);
 	}
+	actors.resize(numAlive);
+}
+
+//Hurt everything standing in the cells marked since the last call, once per
+//cell and in the order they were marked, which is how each spray used to hurt
+//its own cell on its turn. The tick ends once the player is dead, so the
+//cells after the one that kills the player are left alone.
+void StudentWorld::applySprayDamage(){
+	bool tickEnds = false;
+	for (size_t k = 0; k < m_sprayCells.size(); k++){
+		int x = m_sprayCells[k] % m_boardWidth, y = m_sprayCells[k] / m_boardWidth;
+		m_sprayDamage.set(x, y, false);
+		if (tickEnds)
+			continue;
+		//Killing a Zumi can drop a goodie into this very cell, and a sprayer
+		//going off adds sprays, so only visit the actors that were here to begin with
+		const vector<Actor*>& actors = m_grid.at(x, y);
+		for (size_t j = 0, n = actors.size(); j < n; j++){
+			if (actors[j]->isAlive() && actors[j]->isKind(KIND_DESTROYABLE_BRICK | KIND_ZUMI | KIND_BUGSPRAYER)){
+				if (actors[j]->isKind(KIND_DESTROYABLE_BRICK))
+					m_numDeadBricks++;
+				actors[j]->setDead();
+			}
+		}
+		if (m_player->getX() == x && m_player->getY() == y)
+			m_player->setDeadBy(CAUSE_BUG_SPRAY);
+		tickEnds = !m_player->isAlive();
+	}
+	m_sprayCells.clear();
+}
+
+//Bring the bits for (x, y) back in line with the grid after an actor of the
+//given kind arrived or left
+void StudentWorld::updateLayers(int x, int y, unsigned int kind){
+	for (int i = 0; i < NUM_BOARD_LAYERS; i++)
+		if (kind & LAYER_KINDS[i])
+			m_layers[i].set(x, y, containsKind(x, y, LAYER_KINDS[i]));
+}
+
+//Gives everything that keeps a table per cell the level's board size. They
+//are only rebuilt when the size changes; otherwise init has already cleared
+//them.
+void StudentWorld::setBoardSize(int width, int height){
+	if (width == m_boardWidth && height == m_boardHeight)
+		return;
+	m_boardWidth = width;
+	m_boardHeight = height;
+	m_grid = OccupancyGrid(width, height);
+	for (int i = 0; i < NUM_BOARD_LAYERS; i++)
+		m_layers[i] = Bitboard(width, height);
+	m_sprayDamage = Bitboard(width, height);
+	m_playerDistances = DistanceField(width, height);
+	m_blast = BlastEngine(width, height);
+}
+
+//For an actor that dies mid-level: pooled actors go back to their pool, and
+//the rest just leave the board, their memory staying in the arena until the
+//level ends
+void StudentWorld::deleteActor(Actor* actor){
+	switch (actor->getID()){
+	case IID_BUGSPRAY:
+		m_sprayPool.destroy(static_cast<BugSpray*>(actor));
+		break;
+	case IID_BUGSPRAYER:
+		m_sprayerPool.destroy(static_cast<BugSprayer*>(actor));
+		break;
+	case IID_EXTRA_LIFE_GOODIE:
+		m_extraLifePool.destroy(static_cast<ExtraLifeGoodie*>(actor));
+		break;
+	case IID_WALK_THRU_GOODIE:
+		m_walkThruPool.destroy(static_cast<WalkThruGoodie*>(actor));
+		break;
+	case IID_INCREASE_SIMULTANEOUS_SPRAYER_GOODIE:
+		m_extraSprayerPool.destroy(static_cast<ExtraSprayerGoodie*>(actor));
+		break;
+	case IID_INCREASE_SPRAY_RADIUS_GOODIE:
+		m_sprayRadiusPool.destroy(static_cast<SprayRadiusGoodie*>(actor));
+		break;
+	default:
+		actor->~Actor();
+	}
+}
+
+//Ends the level's actors, the player included, in one go. Actors own nothing
+//but their place in the GraphObject registry, so clearing the registry
+//stands in for all their destructors and releasing the arena frees all their
+//memory, however big the map was. (BugSprayer's destructor also counts the
+//sprayer off, but init starts that count from zero anyway.)
+void StudentWorld::deleteAllActors(){
+	clearGraphObjects();
+	m_actors.clear();
+	m_bricks.clear();
+	m_numDeadBricks = 0;
+	m_player = nullptr;
+	m_numZumis = 0;
+	m_grid.clear();
+
+	m_sprayPool.reset();
+	m_sprayerPool.reset();
+	m_extraLifePool.reset();
+	m_walkThruPool.reset();
+	m_extraSprayerPool.reset();
+	m_sprayRadiusPool.reset();
+	m_arena.release();
+}
+
+//Starts another world building the given level on a thread of its own. It
+//reads only its own state, the level file or shared pack, and a copy of this
+//world's generator, which this world leaves alone until init; the actors it
+//builds therefore draw exactly the numbers they would have drawn here.
+void StudentWorld::prefetchLevel(unsigned int levelNumber){
+	discardPrefetch();
+	m_prefetch = new StudentWorld;
+	m_prefetch->startAtLevel(levelNumber);
+	m_prefetch->setTracksGraphObjects(getGraphObjects() != nullptr);
+	m_prefetch->m_levelPack = m_levelPack;
+	m_prefetch->m_random = m_random;
+	m_prefetchThread = thread([this](){
+		m_prefetchResult = m_prefetch->init();
+	});
+}
+
+//The prefetching world only lives until its level is taken or thrown away,
+//so a world never holds two boards' worth of tables for long
+void StudentWorld::discardPrefetch(){
+	if (m_prefetch == nullptr)
+		return;
+	m_prefetchThread.join();
+	delete m_prefetch;
+	m_prefetch = nullptr;
+}
+
+//Trades this world's level, which cleanUp has emptied, for the one built in
+//the background, and gives its actors to this world. What it costs is one
+//pass over the actors instead of loading the level and building them.
+int StudentWorld::adoptPrefetch(){
+	m_prefetchThread.join();
+
+	StudentWorld& next = *m_prefetch;
+	swap(m_boardWidth, next.m_boardWidth);
+	swap(m_boardHeight, next.m_boardHeight);
+	m_actors.swap(next.m_actors);
+	m_bricks.swap(next.m_bricks);
+	swap(m_numDeadBricks, next.m_numDeadBricks);
+	swap(m_numZumis, next.m_numZumis);
+	m_arena.swap(next.m_arena);
+	swap(m_grid, next.m_grid);
+	for (int i = 0; i < NUM_BOARD_LAYERS; i++)
+		swap(m_layers[i], next.m_layers[i]);
+	swap(m_playerDistances, next.m_playerDistances);
+	swap(m_blast, next.m_blast);
+	swap(m_sprayDamage, next.m_sprayDamage);
+	swap(m_player, next.m_player);
+	swap(m_level, next.m_level);
+	m_levelCompleted = next.m_levelCompleted;
+	m_exitRevealed = next.m_exitRevealed;
+	m_numSprayers = next.m_numSprayers;
+	m_bonus = next.m_bonus;
+	m_random = next.m_random;
+
+	swapGraphObjects(next);
+	if (m_player != nullptr)
+		m_player->setWorld(this);
+	for (size_t i = 0; i < m_actors.size(); i++)
+		m_actors[i]->setWorld(this);
+	for (size_t i = 0; i < m_bricks.size(); i++)
+		m_bricks[i]->setWorld(this);
+
+	//It now holds only what cleanUp left of the last level
+	delete m_prefetch;
+	m_prefetch = nullptr;
+	return m_prefetchResult;
 }
 
 void StudentWorld::exposeExit(){
-	for (list<Actor*>::iterator it = m_actorList.begin(); it != m_actorList.end(); it++)
-		if (dynamic_cast<Exit*>(*it))
-			(static_cast<Exit*>(*it))->activate();
+	for (size_t i = 0; i < m_actors.size(); i++)
+		if (m_actors[i]->isKind(KIND_EXIT))
+			(static_cast<Exit*>(m_actors[i]))->activate();
 	m_exitRevealed = true;
 }
 
@@ -3,16 +3,44 @@
 
 #include "GameWorld.h"
 #include "GameConstants.h"
-#include <list>
+#include "RandomGenerator.h"
+#include "OccupancyGrid.h"
+#include "ActorKind.h"
+#include "DistanceField.h"
+#include "Bitboard.h"
+#include "BlastEngine.h"
+#include "LevelArena.h"
+#include "ActorPool.h"
+#include "Level.h"
+#include <vector>
 #include <string>
+#include <thread>
 
 class Actor;
 class Player;
+class BugSprayer;
+class BugSpray;
+class ExtraLifeGoodie;
+class WalkThruGoodie;
+class ExtraSprayerGoodie;
+class SprayRadiusGoodie;
 class Level;
+class LevelPack;
+
+//The bitboards StudentWorld keeps of what is where, one bit per cell
+enum BoardLayer{
+	LAYER_WALLS,		//perma bricks
+	LAYER_BRICKS,		//destroyable bricks
+	LAYER_SPRAYERS,
+	LAYER_ZUMIS,
+	LAYER_SPRAY,
+	NUM_BOARD_LAYERS
+};
 
 class StudentWorld : public GameWorld
 {
 public:
+	StudentWorld();
 	virtual ~StudentWorld();
 	int init();
 	int move();
@@ -20,38 +48,110 @@ public:
 
 	//Mutator
 	void addActor(Actor* actor);
+	//For the short-lived actors: takes the new actor from its type's pool
+	//instead of the heap, then adds it like addActor
+	template<typename Type, typename... Args>
+	Type* addPooled(Args... args){
+		Type* actor = poolFor(static_cast<Type*>(nullptr)).create(args...);
+		addActor(actor);
+		return actor;
+	}
+	void moveActor(Actor* actor, int x, int y);
+	void addSprayDamage(int x, int y);
 	void completeLevel();
+	void detonate(BugSprayer* sprayer);
 	void incNumSprayers();
 	void decNumSprayers();
+	virtual void setSeed(uint64_t seed);
+	void setRandomGenerator(const RandomGenerator& generator);
+	void setLevelPack(const LevelPack* pack);
 
 	//Accessor
 	template<typename Type>
 	bool contains(int x, int y) const{
-		for (list<Actor*>::const_iterator it = m_actorList.begin(); it != m_actorList.end(); it++){
-			if (dynamic_cast<Type*>(*it) && (*it)->getX() == x && (*it)->getY() == y)
-				return true;
-		}
-		return false;
+		return containsKind(x, y, KindOf<Type>::mask);
 	}
+	bool containsKind(int x, int y, unsigned int kindMask) const;
+	const std::vector<Actor*>& getActorsAt(int x, int y) const;
+	const Bitboard& getLayer(BoardLayer layer) const;
 	int getNumSprayers() const;
-	std::list<Actor*>& getActors();
+	int getLastCauseOfDeath() const;
+	int getRand(int n);
+	GoodieDrop rollGoodieDrop();
+	uint64_t getStateHash() const;
+	int getDistToPlayer(int x, int y);
+	const std::vector<BlastCell>& getBlastCells(int x, int y, int radius);
+	const DistanceField& getPlayerDistances() const;
+	const std::vector<Actor*>& getActors() const;
 	Player* getPlayer() const;
 	Level* getCurrentLevel() const;
+	virtual int getBoardWidth() const;
+	virtual int getBoardHeight() const;
+	virtual void getViewOrigin(double& x, double& y) const;
 	
 private:
+	int doMove();
 	int setMap(int levelNumber);
 	std::string toStrFileName(int levelNumber);
 	void removeDead();
+	void removeDeadFrom(std::vector<Actor*>& actors);
+	void applySprayDamage();
 	void exposeExit();
 	void setDisplayText();
+	void updateLayers(int x, int y, unsigned int kind);
+	void setBoardSize(int width, int height);
+	void deleteActor(Actor* actor);
+	void deleteAllActors();
+	void prefetchLevel(unsigned int levelNumber);
+	void discardPrefetch();
+	int adoptPrefetch();
+
+	//Picks the pool for addPooled by overloading on a null Type*
+	ActorPool<BugSpray>& poolFor(BugSpray*){ return m_sprayPool; }
+	ActorPool<BugSprayer>& poolFor(BugSprayer*){ return m_sprayerPool; }
+	ActorPool<ExtraLifeGoodie>& poolFor(ExtraLifeGoodie*){ return m_extraLifePool; }
+	ActorPool<WalkThruGoodie>& poolFor(WalkThruGoodie*){ return m_walkThruPool; }
+	ActorPool<ExtraSprayerGoodie>& poolFor(ExtraSprayerGoodie*){ return m_extraSprayerPool; }
+	ActorPool<SprayRadiusGoodie>& poolFor(SprayRadiusGoodie*){ return m_sprayRadiusPool; }
 
-	std::list<Actor*> m_actorList;
+	int m_boardWidth;
+	int m_boardHeight;
+	//One vector of pointers in act order. Which actor goes before which is
+	//part of the game and of every recorded replay, so removeDead keeps the
+	//order. Storing the actors themselves by type (with a sequence number to
+	//act in) has not been done; each actor is still one pointer away.
+	std::vector<Actor*> m_actors;	//oldest first; everything but the bricks
+	std::vector<Actor*> m_bricks;	//which never act, so stay out of the tick loop
+	int m_numDeadBricks;
+	int m_numZumis;
+	LevelArena m_arena;		//every actor's memory, the pools' included
+	ActorPool<BugSpray> m_sprayPool;
+	ActorPool<BugSprayer> m_sprayerPool;
+	ActorPool<ExtraLifeGoodie> m_extraLifePool;
+	ActorPool<WalkThruGoodie> m_walkThruPool;
+	ActorPool<ExtraSprayerGoodie> m_extraSprayerPool;
+	ActorPool<SprayRadiusGoodie> m_sprayRadiusPool;
+	OccupancyGrid m_grid;
+	Bitboard m_layers[NUM_BOARD_LAYERS];
+	DistanceField m_playerDistances;
+	BlastEngine m_blast;
+	std::vector<BlastCell> m_blastCells;
+	Bitboard m_sprayDamage;		//the cells in m_sprayCells
+	std::vector<int> m_sprayCells;	//marked by sprays for applySprayDamage, in order
 	Player* m_player;
 	Level* m_level;
+	const LevelPack* m_levelPack;	//or nullptr to read levelNN files
 	bool m_levelCompleted;
 	bool m_exitRevealed;
 	int m_numSprayers;
 	int m_bonus;
+	int m_lastCauseOfDeath;
+	RandomGenerator m_random;
+	//The next level, built on m_prefetchThread by a world of its own while
+	//the player is told they finished this one
+	StudentWorld* m_prefetch;		//or nullptr if not building one
+	std::thread m_prefetchThread;
+	int m_prefetchResult;
 };
 
 #endif // STUDENTWORLD_H_
@@ -13,6 +13,9 @@
 
 #include "GameController.h"
 #include "GameConstants.h"
+#include "Replay.h"
+#include <iostream>
+#include <string>
 #include <cstdlib>
 #include <ctime>
 using namespace std;
@@ -25,12 +28,28 @@ int main(int argc, char* argv[])
 {
 	glutInit(&argc, argv);
 
+    GameWorld* gw = createStudentWorld();
+
+      // "-record FILE" saves the session for bugblast-headless -replay.  The
+      // recorder is static so that exit() still flushes it on quit.
+    static ReplayRecorder recorder;
+    if (argc >= 3  &&  std::string(argv[1]) == "-record")
+    {
+        uint64_t seed = static_cast<uint64_t>(time(NULL));
+        gw->setSeed(seed);
+        if (recorder.open(argv[2], seed, gw->getLevel()))
+            gw->setTickObserver(&recorder);
+        else
+            cout << "Cannot write " << argv[2] << "!  Game will not be recorded." << endl;
+        argc -= 2;
+        argv += 2;
+    }
+
     int testParams[NUM_TEST_PARAMS];
     for (int i = 0; i < NUM_TEST_PARAMS; i++)
         testParams[i] = (i+1 < argc) ? atoi(argv[i+1]) : 0;
 
     srand(static_cast<unsigned int>(time(NULL)));
 
-    GameWorld* gw = createStudentWorld();
     Game().run(gw, testParams, "Bug Blast");
 }